@@ -8,12 +8,19 @@ CONFIG += c++11
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Solver condiviso con la riga di comando, senza dipendenze da Qt
+INCLUDEPATH += ../../sudoku
+
 SOURCES += \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    solverworker.cpp
 
 HEADERS += \
-    mainwindow.h
+    ../../bits.h \
+    ../../sudoku/sudoku.h \
+    mainwindow.h \
+    solverworker.h
 
 FORMS += \
     mainwindow.ui
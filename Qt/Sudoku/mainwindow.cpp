@@ -5,9 +5,21 @@
 #include <QMessageBox>
 
 MainWindow::MainWindow(QWidget *parent): QMainWindow(parent),
-        ui(new Ui::MainWindow) {
+        ui(new Ui::MainWindow), worker(new SolverWorker) {
     ui->setupUi(this);
 
+    // Le ricerche girano nel thread del worker; i risultati tornano qui
+    // con segnali accodati, quindi Sudoku deve essere registrato
+    qRegisterMetaType<Sudoku>("Sudoku");
+    worker->moveToThread(&solver_thread);
+    connect(&solver_thread, &QThread::finished,
+            worker, &QObject::deleteLater);
+    connect(worker, &SolverWorker::searchProgress,
+            this, &MainWindow::show_progress);
+    connect(worker, &SolverWorker::finished,
+            this, &MainWindow::solve_finished);
+    solver_thread.start();
+
     setFixedSize(700, 700); // Dimensioni finestra fisse
 
     // Blocco l'inserimento di caratteri non numerici
@@ -22,7 +34,9 @@ MainWindow::MainWindow(QWidget *parent): QMainWindow(parent),
 }
 
 MainWindow::~MainWindow() {
-    moves.clear();
+    worker->cancel();
+    solver_thread.quit();
+    solver_thread.wait();
     delete ui;
 }
 
@@ -43,28 +57,61 @@ void MainWindow::on_pushButton_resolve_clicked()
     save_sudoku();
 
     //Controllo se il sudoku in input è valido
-    for (int i = 0; i < 9; ++i) {
-        for (int j = 0; j < 9; ++j) {
-            if (sudoku[i][j] != 0 && !valid_cell(i, j)) {
-                QMessageBox::warning(this, tr("Errore"),
-                                     tr("Sudoku inserito non valido."));
-                return;
-            }
-        }
+    if (!sudoku.valid()) {
+        QMessageBox::warning(this, tr("Errore"),
+                             tr("Sudoku inserito non valido."));
+        return;
     }
 
-    if (solve()) {
-        print_sudoku();
+    // La ricerca parte nel thread del worker: la finestra resta reattiva e
+    // solve_finished riceve il risultato
+    ui->pushButton_clear->setEnabled(false);
+    ui->pushButton_cancel->setEnabled(true);
+    ui->label_status->setText(tr("Ricerca in corso..."));
+    worker->start(sudoku, SOLVE_TIMEOUT_MS);
+}
+
+void MainWindow::on_pushButton_cancel_clicked() {
+    ui->pushButton_cancel->setEnabled(false);
+    worker->cancel();
+}
+
+void MainWindow::show_progress(qulonglong nodes, int depth) {
+    ui->label_status->setText(tr("Nodi: %1, profondità: %2")
+                              .arg(nodes).arg(depth));
+}
+
+void MainWindow::solve_finished(const Sudoku &result, int outcome) {
+    ui->pushButton_cancel->setEnabled(false);
+    ui->pushButton_clear->setEnabled(true);
+
+    if (outcome == SolverWorker::CANCELLED) {
+        ui->label_status->setText(tr("Ricerca annullata."));
+        unlock_sudoku();
+        return;
+    }
+    if (outcome == SolverWorker::TIMED_OUT) {
+        ui->label_status->setText(tr("Tempo scaduto."));
+        unlock_sudoku();
+        return;
     }
-    else{
+    if (outcome == SolverWorker::NO_SOLUTION) {
+        ui->label_status->setText("");
+        unlock_sudoku();
         QMessageBox::warning(this, tr("Errore"),
                              tr("Impossibile risolvere il Sudoku."));
         return;
     }
 
+    // Soluzione e mosse arrivano insieme
+    sudoku = result;
+    ui->label_status->setText(tr("Risolto in %1 nodi.")
+                              .arg(sudoku.nodes()));
+    print_sudoku();
+
     //Abilito la navigazione tra le mosse
-    current_move = moves.cbegin();
-    if(current_move != moves.cend()) {
+    current_move = sudoku.moves().cbegin();
+    if(current_move != sudoku.moves().cend()) {
         ui->pushButton_previous->setEnabled(true);
         ui->pushButton_begin->setEnabled(true);
     }
@@ -72,8 +119,8 @@ void MainWindow::on_pushButton_resolve_clicked()
 
 void MainWindow::on_pushButton_clear_clicked() {
     // Svuoto pila mosse
-    current_move = nullptr;
-    moves.clear();
+    sudoku.clear();
+    current_move = sudoku.moves().cend();
 
     // Disabilito navigazione mosse
     ui->pushButton_previous->setEnabled(false);
@@ -94,6 +141,7 @@ void MainWindow::on_pushButton_clear_clicked() {
 
     // Abilito bottone risolvi
     ui->pushButton_resolve->setEnabled(true);
+    ui->label_status->setText("");
 }
 
 void MainWindow::on_pushButton_previous_clicked()
@@ -108,7 +156,7 @@ void MainWindow::on_pushButton_previous_clicked()
 
     ++current_move;
     //Se non ci sono mosse precedenti disattivo il bottone.
-    if(current_move == moves.cend()) {
+    if(current_move == sudoku.moves().cend()) {
         ui->pushButton_previous->setEnabled(false);
         ui->pushButton_begin->setEnabled(false);
     }
@@ -120,7 +168,7 @@ void MainWindow::on_pushButton_previous_clicked()
 void MainWindow::on_pushButton_begin_clicked()
 {
     //Rimuovo tutte le mosse
-    while(current_move != moves.cend()) {
+    while(current_move != sudoku.moves().cend()) {
         QWidget* w = ui->gridLayout->itemAtPosition(
                     current_move->row,
                     current_move->column
@@ -142,7 +190,7 @@ void MainWindow::on_pushButton_next_clicked()
 {
     --current_move;
     //Se non ci sono mosse successive disattivo il bottone.
-    if(current_move == moves.cbegin()) {
+    if(current_move == sudoku.moves().cbegin()) {
         ui->pushButton_next->setEnabled(false);
         ui->pushButton_end->setEnabled(false);
     }
@@ -162,7 +210,7 @@ void MainWindow::on_pushButton_next_clicked()
 void MainWindow::on_pushButton_end_clicked()
 {
     //Mostro tutte le mosse
-    while(current_move != moves.cbegin()) {
+    while(current_move != sudoku.moves().cbegin()) {
         --current_move;
         QWidget *w = ui->gridLayout->itemAtPosition(
                     current_move->row,
@@ -180,92 +228,45 @@ void MainWindow::on_pushButton_end_clicked()
     ui->pushButton_begin->setEnabled(true);
 }
 
-bool MainWindow::solve() {
-    int row, column;
-    if (!find_empty_cell(row, column)) {
-        // Tutte le celle sono state risolte
-        return true;
-    }
-
-    sudoku[row][column] = 1;
-    while (sudoku[row][column] <= 9) {
-        if (valid_cell(row, column) && solve()) {
-            moves.append(Move(row, column, sudoku[row][column]));
-            return true;
-        }
-        ++(sudoku[row][column]);
-    }
-
-    sudoku[row][column] = 0;
-    return false;
-}
-
-bool MainWindow::find_empty_cell(int& row, int& column) {
-    for (row = 0; row < 9; ++row) {
-        for (column = 0; column < 9; ++column) {
-            if (sudoku[row][column] == 0) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 void MainWindow::save_sudoku(){
     for (int i = 0; i < 9; ++i) {
         for (int j = 0; j < 9; ++j) {
             QWidget *w = ui->gridLayout->itemAtPosition(i, j)->widget();
             QLineEdit* cell = static_cast<QLineEdit*>(w);
             if (cell->text().length() > 0) {
-                sudoku[i][j] = cell->text().toShort();
+                sudoku.set(i, j, cell->text().toShort());
             }
             else {
-                sudoku[i][j] = 0; //Cella non compilata
+                sudoku.set(i, j, 0); //Cella non compilata
             }
         }
     }
 }
 
-bool MainWindow::valid_cell(const int& row, const int& column) {
-    short number = sudoku[row][column];
-
-    //Controllo riga
+void MainWindow::unlock_sudoku() {
     for (int i = 0; i < 9; ++i) {
-        if (i != column && sudoku[row][i] == number) {
-            return false;
-        }
-    }
-
-    //Controllo colonna
-    for (int i = 0; i < 9; ++i) {
-        if (i != row && sudoku[i][column] == number) {
-            return false;
-        }
-    }
-
-    //Controllo casella 3x3
-    int box_row = row - (row % 3);
-    int box_column = column - (column % 3);
-    for (int i = box_row; i < box_row + 3; ++i) {
-        for (int j = box_column; j < box_column + 3; ++j) {
-            if ((i != row || j != column) && sudoku[i][j] == number) {
-                return false;
-            }
+        for (int j = 0; j < 9; ++j) {
+            QWidget *w = ui->gridLayout->itemAtPosition(i, j)->widget();
+            QLineEdit* cell = static_cast<QLineEdit*>(w);
+            cell->setReadOnly(false);
         }
     }
-
-    return true;
+    ui->pushButton_resolve->setEnabled(true);
 }
 
 void MainWindow::print_sudoku() {
-    for (int i = 0; i < 9; ++i) {
-        for (int j = 0; j < 9; ++j) {
-            QWidget *w = ui->gridLayout->itemAtPosition(i, j)->widget();
-            QLineEdit* cell = static_cast<QLineEdit*>(w);
-            if(cell->text().isEmpty() || cell->text().toInt() == 0){
-                cell->setStyleSheet("color: red");
-                cell->setText(QString::number(sudoku[i][j]));
-            }
+    // Le mosse coprono esattamente le celle non compilate
+    std::vector<Sudoku::Move>::const_iterator m;
+    for (m = sudoku.moves().cbegin(); m != sudoku.moves().cend(); ++m) {
+        QWidget *w = ui->gridLayout->itemAtPosition(m->row, m->column)
+                ->widget();
+        QLineEdit* cell = static_cast<QLineEdit*>(w);
+        if (m->kind == Sudoku::GUESS) {
+            cell->setStyleSheet("color: red");
+        }
+        else {
+            cell->setStyleSheet("color: blue"); // Dedotta dalla propagazione
         }
+        cell->setText(QString::number(m->value));
     }
 }
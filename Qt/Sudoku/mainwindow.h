@@ -2,8 +2,13 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QVector>
 #include <QIntValidator>
+#include <QThread>
+
+#include <vector>
+
+#include "sudoku.h"
+#include "solverworker.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -29,62 +34,55 @@ private slots:
 
     void on_pushButton_end_clicked();
 
-private:
-    QIntValidator validator;
+    void on_pushButton_cancel_clicked();
 
-    short sudoku[9][9]; ///< Matrice contenente il Sudoku
+    /**
+     * @brief Mostra l'avanzamento della ricerca nella barra di stato.
+     */
+    void show_progress(qulonglong nodes, int depth);
+
+    /**
+     * @brief Riceve dal worker il risultato della ricerca e le mosse.
+     */
+    void solve_finished(const Sudoku &result, int outcome);
 
+private:
     /**
-     * @brief Struct contenente una mossa.
+     * @brief Durata massima di una ricerca in millisecondi.
      */
-    struct Move {
-        int row;
-        int column;
-        short value;
+    static const int SOLVE_TIMEOUT_MS = 30000;
 
-        Move(): row(0), column(0), value(0) {}
-        Move(int r, int c, int v): row(r), column(c), value(v) {}
-    };
-    QVector<Move> moves; ///< Mosse effettuate dal solver
-    QVector<Move>::const_iterator current_move;
+    QIntValidator validator;
 
-    Ui::MainWindow *ui;
+    Sudoku sudoku; ///< Sudoku e solver, condiviso con la riga di comando
 
     /**
-     * @brief Funzione che risolve il Sudoku in modo ricorsivo.
-     * @return true se il sudoku è stato risolto, false altrimenti.
+     * @brief Mossa più recente mostrata nella griglia.
+     * Scorre sudoku.moves(), che elenca le mosse dalla più recente alla prima.
      */
-    bool solve();
+    std::vector<Sudoku::Move>::const_iterator current_move;
+
+    Ui::MainWindow *ui;
+
+    QThread solver_thread; ///< Thread in cui vive worker
+    SolverWorker *worker; ///< Esegue le ricerche fuori dal thread della UI
 
     /**
      * @brief Salva i valori inseriti tramite UI nella variabile sudoku.
      */
     void save_sudoku();
 
-    /**
-     * @brief Funzione che controlla la validità di una cella nel Sudoku.
-     * @param row Riga della cella da validare
-     * @param column Colonna della cella da validare
-     * @return true se la cella rispetta le regole del Sudoku, false altrimenti.
-     */
-    bool valid_cell(const int& row, const int& column);
-
     /**
      * @brief Mostra il contenuto di Sudoku tramite UI.
-     * Mostra nell'interfaccia grafica i valori ottenuti dal solver con il
-     * colore rosso.
+     * Mostra nell'interfaccia grafica i valori ottenuti dal solver: in rosso
+     * quelli scelti dalla ricerca, in blu quelli dedotti dalla propagazione.
      */
     void print_sudoku();
 
     /**
-     * @brief Trova una cella vuota nel sudoku.
-     * I parametri row e column vengono usati come output se viene trovata una
-     * cella vuota.
-     *
-     * @param row Riga della cella eventualmente trovata.
-     * @param column Colonna della cella eventualmente trovata
-     * @return true se è stata trovata una cella vuota, false altrimenti.
+     * @brief Rende di nuovo modificabile la griglia dopo una ricerca non
+     * riuscita.
      */
-    bool find_empty_cell(int& row, int& column);
+    void unlock_sudoku();
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,51 @@
+#include "solverworker.h"
+
+SolverWorker::SolverWorker(QObject *parent): QObject(parent),
+        cancelled(false), timed_out(false) {
+    // Emesso dal thread dell'interfaccia, eseguito in quello del worker
+    connect(this, &SolverWorker::requested, this, &SolverWorker::solve);
+}
+
+void SolverWorker::start(const Sudoku &sudoku, int timeout_ms) {
+    // Azzerato prima di accodare la richiesta, così un cancel() arrivato
+    // prima che la ricerca parta non va perso
+    cancelled = false;
+    emit requested(sudoku, timeout_ms);
+}
+
+void SolverWorker::cancel() {
+    cancelled = true;
+}
+
+void SolverWorker::solve(const Sudoku &sudoku, int timeout_ms) {
+    timed_out = false;
+    deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+    next_progress = clock::now();
+
+    Sudoku result(sudoku);
+    const bool solved = result.solve(*this);
+    emit searchProgress(result.nodes(), 0);
+
+    if (solved) {
+        emit finished(result, SOLVED);
+    }
+    else if (!result.interrupted()) {
+        emit finished(sudoku, NO_SOLUTION);
+    }
+    else {
+        emit finished(sudoku, timed_out ? TIMED_OUT : CANCELLED);
+    }
+}
+
+bool SolverWorker::progress(unsigned long long nodes, int depth) {
+    const clock::time_point now = clock::now();
+    if (now >= deadline) {
+        timed_out = true;
+        return false;
+    }
+    if (now >= next_progress) {
+        next_progress = now + std::chrono::milliseconds(PROGRESS_MS);
+        emit searchProgress(nodes, depth);
+    }
+    return !cancelled;
+}
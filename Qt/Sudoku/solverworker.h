@@ -0,0 +1,90 @@
+#ifndef SOLVERWORKER_H
+#define SOLVERWORKER_H
+
+#include <QObject>
+#include <QMetaType>
+
+#include <atomic>
+#include <chrono>
+
+#include "sudoku.h"
+
+Q_DECLARE_METATYPE(Sudoku)
+
+/**
+ * @brief Risolve un Sudoku nel thread in cui vive, fuori dal thread
+ * dell'interfaccia.
+ *
+ * Va spostato in un QThread con moveToThread. start() può essere chiamato
+ * dal thread dell'interfaccia: la ricerca parte nel thread del worker, che
+ * durante la ricerca emette searchProgress al massimo ogni PROGRESS_MS e alla
+ * fine emette finished una sola volta, con il Sudoku risolto e le sue
+ * mosse. cancel() e il timeout fermano la ricerca al successivo controllo,
+ * ogni 1024 nodi.
+ */
+class SolverWorker : public QObject, private SudokuMonitor
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Esito di una ricerca.
+     */
+    enum Outcome {
+        SOLVED, ///< Sudoku risolto
+        NO_SOLUTION, ///< Griglia non valida o senza soluzioni
+        CANCELLED, ///< Fermato da cancel()
+        TIMED_OUT ///< Fermato dal timeout
+    };
+
+    enum {
+        PROGRESS_MS = 100 ///< Intervallo minimo tra due searchProgress
+    };
+
+    explicit SolverWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief Chiede di risolvere sudoku nel thread del worker.
+     *
+     * @param sudoku Sudoku da risolvere, copiato.
+     * @param timeout_ms Durata massima della ricerca in millisecondi.
+     */
+    void start(const Sudoku &sudoku, int timeout_ms);
+
+    /**
+     * @brief Ferma la ricerca in corso; può essere chiamato da ogni thread.
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief Avanzamento della ricerca: nodi visitati e scelte nel ramo
+     * corrente.
+     */
+    void searchProgress(qulonglong nodes, int depth);
+
+    /**
+     * @brief Fine della ricerca: il Sudoku risolto, con le mosse, se
+     * outcome è SOLVED, altrimenti quello ricevuto.
+     */
+    void finished(const Sudoku &result, int outcome);
+
+    /**
+     * @brief Collegato a solve, per eseguirlo nel thread del worker.
+     */
+    void requested(const Sudoku &sudoku, int timeout_ms);
+
+private slots:
+    void solve(const Sudoku &sudoku, int timeout_ms);
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    std::atomic<bool> cancelled; ///< Richiesta di cancel()
+    bool timed_out; ///< Ricerca fermata dal timeout
+    clock::time_point deadline; ///< Fine del tempo a disposizione
+    clock::time_point next_progress; ///< Prossimo searchProgress
+
+    bool progress(unsigned long long nodes, int depth) override;
+};
+
+#endif // SOLVERWORKER_H
@@ -0,0 +1,186 @@
+#ifndef arena_h
+#define arena_h
+
+#include <cstddef> // std::size_t
+#include <new> // ::operator new std::bad_alloc
+
+
+/**
+ * @brief Arena monotona per oggetti a vita breve.
+ *
+ * La memoria viene ottenuta dal sistema a blocchi di dimensione crescente e
+ * distribuita spostando un puntatore. Le singole deallocazioni non hanno
+ * effetto: tutta la memoria viene restituita insieme con release() o alla
+ * distruzione dell'arena.
+ *
+ * Pensata per grafi costruiti, interrogati e distrutti nell'arco di una
+ * singola richiesta.
+ */
+class MonotonicArena {
+    /**
+     * @brief Intestazione di un blocco di memoria dell'arena.
+     */
+    struct Block {
+        Block* next; ///< Blocco allocato in precedenza
+        std::size_t size; ///< Dimensione utile del blocco in byte
+    };
+
+    Block* _head; ///< Blocco corrente
+    char* _cursor; ///< Prima posizione libera nel blocco corrente
+    char* _limit; ///< Fine del blocco corrente
+    std::size_t _initial_size; ///< Dimensione del primo blocco
+    std::size_t _next_size; ///< Dimensione del prossimo blocco
+    std::size_t _allocated; ///< Byte distribuiti dall'arena
+
+    /**
+     * @brief Ottiene un nuovo blocco che possa contenere almeno bytes byte.
+     *
+     * @param bytes Dimensione minima richiesta.
+     * @throw std::bad_alloc
+     */
+    void grow(std::size_t bytes) {
+        std::size_t size = _next_size;
+        while (size < bytes + alignof(std::max_align_t)) {
+            size *= 2;
+        }
+
+        void* raw = ::operator new(sizeof(Block) + size);
+        Block* block = static_cast<Block*>(raw);
+        block->next = _head;
+        block->size = size;
+        _head = block;
+
+        _cursor = reinterpret_cast<char*>(block + 1);
+        _limit = _cursor + size;
+        _next_size = size * 2;
+    }
+
+    MonotonicArena(const MonotonicArena&); // Non copiabile
+    MonotonicArena& operator=(const MonotonicArena&); // Non assegnabile
+
+public:
+
+    /**
+     * @brief Costruttore.
+     *
+     * Nessuna memoria viene allocata fino alla prima richiesta.
+     *
+     * @param initial_size Dimensione in byte del primo blocco.
+     */
+    explicit MonotonicArena(std::size_t initial_size = 4096) :
+            _head(nullptr), _cursor(nullptr), _limit(nullptr),
+            _initial_size(initial_size == 0 ? 1 : initial_size),
+            _next_size(_initial_size), _allocated(0) {}
+
+    /**
+     * @brief Distruttore, restituisce tutti i blocchi al sistema.
+     */
+    ~MonotonicArena() {
+        release();
+    }
+
+    /**
+     * @brief Alloca bytes byte allineati ad align.
+     *
+     * @param bytes Numero di byte richiesti.
+     * @param align Allineamento richiesto, potenza di 2.
+     * @return Puntatore alla memoria allocata.
+     * @throw std::bad_alloc
+     */
+    void* allocate(std::size_t bytes, std::size_t align) {
+        std::size_t misalign = reinterpret_cast<std::size_t>(_cursor) &
+                               (align - 1);
+        std::size_t padding = misalign ? align - misalign : 0;
+
+        if (_cursor == nullptr ||
+                static_cast<std::size_t>(_limit - _cursor) < padding + bytes) {
+            grow(bytes + align);
+            misalign = reinterpret_cast<std::size_t>(_cursor) & (align - 1);
+            padding = misalign ? align - misalign : 0;
+        }
+
+        char* p = _cursor + padding;
+        _cursor = p + bytes;
+        _allocated += bytes;
+        return p;
+    }
+
+    /**
+     * @brief Le singole deallocazioni vengono ignorate.
+     */
+    void deallocate(void*, std::size_t) {}
+
+    /**
+     * @brief Restituisce al sistema tutta la memoria dell'arena.
+     *
+     * Tutti i puntatori ottenuti dall'arena diventano invalidi.
+     */
+    void release() {
+        while (_head != nullptr) {
+            Block* next = _head->next;
+            ::operator delete(_head);
+            _head = next;
+        }
+        _cursor = nullptr;
+        _limit = nullptr;
+        _next_size = _initial_size;
+        _allocated = 0;
+    }
+
+    /**
+     * @brief Ritorna il numero di byte distribuiti dall'ultima release().
+     */
+    std::size_t allocated() const {
+        return _allocated;
+    }
+};
+
+/**
+ * @brief Allocatore che ottiene la memoria da una MonotonicArena.
+ *
+ * L'arena deve sopravvivere a tutti i container che usano l'allocatore.
+ * Due ArenaAllocator sono uguali se riferiscono la stessa arena.
+ *
+ * @param T tipo degli oggetti allocati
+ */
+template <typename T>
+class ArenaAllocator {
+    MonotonicArena* _arena; ///< Arena da cui ottenere la memoria
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    typedef T value_type;
+
+    /**
+     * @brief Costruttore, l'allocatore riferisce arena.
+     */
+    explicit ArenaAllocator(MonotonicArena& arena) : _arena(&arena) {}
+
+    /**
+     * @brief Costruttore di conversione usato da rebind.
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other._arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return _arena == other._arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return _arena != other._arena;
+    }
+};
+
+#endif //arena_h
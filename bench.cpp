@@ -0,0 +1,909 @@
+#include <iostream> //std::cout
+#include <sstream> //std::ostringstream
+#include <string> //std::string std::to_string
+#include <vector> //std::vector
+#include <utility> //std::pair
+#include <chrono> //std::chrono::steady_clock
+#include <cstdlib> //std::malloc std::free
+#include <new> //std::bad_alloc
+
+#include <sys/resource.h> //getrusage
+
+#include "digraph.h"
+#include "arena.h"
+#include "mapped.h"
+
+/**
+ * @file bench.cpp
+ * @brief Benchmark di Digraph.
+ *
+ * Ogni misura produce una riga CSV sullo standard output con le colonne
+ * bench,type,nodes,density,ops,ns_per_op,allocs_per_op,bytes_per_op,
+ * peak_rss_kb,minflt_per_op,majflt_per_op, così i risultati di due versioni
+ * possono essere confrontati con diff o importati in un foglio di calcolo.
+ * peak_rss_kb è il picco di memoria residente del processo fino a quel
+ * momento, quindi è non decrescente. minflt_per_op e majflt_per_op sono i
+ * page fault senza e con lettura dal disco.
+ */
+
+static unsigned long g_allocs = 0; ///< Allocazioni eseguite con new
+static unsigned long g_bytes = 0; ///< Byte allocati con new
+
+/**
+ * @brief Allocazione contata, usata da tutte le versioni di operator new.
+ */
+static void* countedAllocate(std::size_t size) {
+    ++g_allocs;
+    g_bytes += size;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * @brief Rilascio usato da tutte le versioni di operator delete, simmetrico
+ * a countedAllocate: con le due coppie malloc/free dietro gli stessi
+ * helper il bench compila senza -Wmismatched-new-delete.
+ */
+static void countedRelease(void* p) noexcept {
+    std::free(p);
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void* p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+/**
+ * @brief Funtore di uguaglianza tra int, come in main.cpp
+ */
+struct Int_equal {
+    bool operator()(const int& a, const int& b) const {
+        return a == b;
+    }
+};
+
+/**
+ * @brief Struct custom, come in main.cpp
+ */
+struct Person {
+    std::string _first_name;
+    std::string _last_name;
+    char _eyes_color;
+
+    Person() : _eyes_color('B') {}
+
+    Person(const std::string& first_name,
+            const std::string& last_name,
+            char eyes_color) :
+        _first_name(first_name),
+        _last_name(last_name),
+        _eyes_color(eyes_color) {}
+};
+
+/**
+ * @brief Funtore di uguaglianza tra Person, come in main.cpp
+ */
+struct Person_equal {
+    bool operator()(const Person& a, const Person& b) const {
+        return (a._first_name == b._first_name &&
+            a._last_name == b._last_name);
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const Person& p) {
+    os << p._first_name;
+    return os;
+}
+
+/**
+ * @brief Genera l'identificativo i-esimo per il tipo di nodo.
+ */
+template <typename T>
+struct NodeFactory;
+
+template <>
+struct NodeFactory<int> {
+    static const char* name() { return "int"; }
+    static int make(int i) { return i; }
+};
+
+template <>
+struct NodeFactory<Person> {
+    static const char* name() { return "Person"; }
+    static Person make(int i) {
+        return Person("Name" + std::to_string(i), "Surname", 'B');
+    }
+};
+
+/**
+ * @brief Misura di un benchmark: tempo, allocazioni e page fault tra start
+ * e stop.
+ */
+class Probe {
+    typedef std::chrono::steady_clock clock;
+
+    const char* _bench;
+    const char* _type;
+    unsigned int _nodes;
+    double _density;
+    clock::time_point _start;
+    unsigned long _allocs;
+    unsigned long _bytes;
+    struct rusage _usage;
+
+public:
+    Probe(const char* bench, const char* type, unsigned int nodes,
+            double density) : _bench(bench), _type(type), _nodes(nodes),
+            _density(density), _start(clock::now()), _allocs(g_allocs),
+            _bytes(g_bytes) {
+        getrusage(RUSAGE_SELF, &_usage);
+    }
+
+    /**
+     * @brief Termina la misura e scrive la riga CSV.
+     *
+     * @param ops Numero di operazioni eseguite dall'inizio della misura.
+     */
+    void stop(unsigned long ops) {
+        const double ns = std::chrono::duration<double, std::nano>(
+            clock::now() - _start).count();
+        const unsigned long allocs = g_allocs - _allocs;
+        const unsigned long bytes = g_bytes - _bytes;
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        if (ops == 0) {
+            ops = 1;
+        }
+        std::cout << _bench << ',' << _type << ',' << _nodes << ','
+                  << _density << ',' << ops << ',' << (ns / ops) << ','
+                  << (double(allocs) / ops) << ',' << (double(bytes) / ops)
+                  << ',' << usage.ru_maxrss << ','
+                  << (double(usage.ru_minflt - _usage.ru_minflt) / ops) << ','
+                  << (double(usage.ru_majflt - _usage.ru_majflt) / ops)
+                  << '\n';
+    }
+};
+
+/**
+ * @brief Generatore pseudo-casuale deterministico, uguale tra esecuzioni.
+ */
+struct Lcg {
+    unsigned long long state;
+
+    explicit Lcg(unsigned long long seed) : state(seed) {}
+
+    unsigned int next(unsigned int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned int>((state >> 33) % bound);
+    }
+};
+
+/**
+ * @brief Coppie (u, v) distinte scelte con la densità indicata.
+ */
+std::vector<std::pair<int, int> > edgeList(int nodes, double density) {
+    std::vector<std::pair<int, int> > edges;
+    Lcg rng(nodes * 7919 + static_cast<int>(density * 1000));
+    const unsigned int threshold = static_cast<unsigned int>(density * 1000);
+
+    for (int i = 0; i < nodes; ++i) {
+        for (int j = 0; j < nodes; ++j) {
+            if (rng.next(1000) < threshold) {
+                edges.push_back(std::make_pair(i, j));
+            }
+        }
+    }
+    return edges;
+}
+
+/**
+ * @brief Misura le operazioni del Digraph con nodi di tipo T.
+ */
+template <typename T, typename E>
+void operationsBench(int nodes, double density) {
+    typedef Digraph<T, E> Graph;
+    typedef NodeFactory<T> Factory;
+
+    std::vector<T> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(Factory::make(i));
+    }
+    const std::vector<std::pair<int, int> > edges = edgeList(nodes, density);
+
+    Graph g;
+    {
+        Probe p("addNode", Factory::name(), nodes, density);
+        for (int i = 0; i < nodes; ++i) {
+            g.addNode(ids[i]);
+        }
+        p.stop(nodes);
+    }
+    {
+        Probe p("addEdge", Factory::name(), nodes, density);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            g.addEdge(ids[edges[e].first], ids[edges[e].second]);
+        }
+        p.stop(edges.size());
+    }
+    {
+        const unsigned int queries = 20000;
+        Lcg rng(42);
+        unsigned int found = 0;
+        Probe p("hasEdge", Factory::name(), nodes, density);
+        for (unsigned int q = 0; q < queries; ++q) {
+            found += g.hasEdge(ids[rng.next(nodes)], ids[rng.next(nodes)]);
+        }
+        p.stop(queries);
+        if (found > queries) {
+            std::cout << "hasEdge: risultato non coerente" << std::endl;
+        }
+    }
+    {
+        const unsigned int copies = 20;
+        unsigned int total = 0;
+        Probe p("copy", Factory::name(), nodes, density);
+        for (unsigned int c = 0; c < copies; ++c) {
+            Graph copy(g);
+            total += copy.edgesNumber();
+        }
+        p.stop(copies);
+        if (total != copies * g.edgesNumber()) {
+            std::cout << "copy: risultato non coerente" << std::endl;
+        }
+    }
+    {
+        // Copia seguita da una modifica: duplica una sola fascia di righe
+        const unsigned int copies = 20;
+        const T first = Factory::make(0);
+        const T last = Factory::make(nodes - 1);
+        Probe p("copy_first_write", Factory::name(), nodes, density);
+        for (unsigned int c = 0; c < copies; ++c) {
+            Graph copy(g);
+            if (copy.hasEdge(first, last)) {
+                copy.removeEdge(first, last);
+            }
+            else {
+                copy.addEdge(first, last);
+            }
+        }
+        p.stop(copies);
+    }
+    {
+        const unsigned int copies = 20;
+        Graph target;
+        Probe p("assignment", Factory::name(), nodes, density);
+        for (unsigned int c = 0; c < copies; ++c) {
+            target = g;
+        }
+        p.stop(copies);
+    }
+    {
+        const unsigned int rounds = 1000;
+        unsigned long visited = 0;
+        const T* volatile sink = nullptr;
+        Probe p("iteration", Factory::name(), nodes, density);
+        for (unsigned int r = 0; r < rounds; ++r) {
+            for (typename Graph::const_iterator i = g.begin(); i != g.end();
+                    ++i) {
+                sink = &*i;
+                ++visited;
+            }
+        }
+        p.stop(visited);
+        (void)sink;
+    }
+    {
+        std::ostringstream os;
+        Probe p("operator<<", Factory::name(), nodes, density);
+        os << g;
+        p.stop(1);
+    }
+    {
+        Probe p("removeNode", Factory::name(), nodes, density);
+        for (int i = nodes - 1; i >= 0; --i) {
+            g.removeNode(ids[i]);
+        }
+        p.stop(nodes);
+    }
+}
+
+/**
+ * @brief Cicli costruzione/distruzione con allocatore di default e arena.
+ */
+void allocatorBench(int nodes, int cycles) {
+    typedef Digraph<int, Int_equal> DefaultGraph;
+    typedef Digraph<int, Int_equal, ArenaAllocator<int> > ArenaGraph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    const std::vector<std::pair<int, int> > edges = edgeList(nodes, 0.1);
+
+    {
+        Probe p("build_destroy_default", "int", nodes, 0.1);
+        for (int c = 0; c < cycles; ++c) {
+            DefaultGraph g;
+            for (int i = 0; i < nodes; ++i) {
+                g.addNode(i);
+            }
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                g.addEdge(edges[e].first, edges[e].second);
+            }
+        }
+        p.stop(cycles);
+    }
+
+    MonotonicArena arena;
+    {
+        Probe p("build_destroy_arena", "int", nodes, 0.1);
+        for (int c = 0; c < cycles; ++c) {
+            {
+                ArenaGraph g((ArenaAllocator<int>(arena)));
+                for (int i = 0; i < nodes; ++i) {
+                    g.addNode(i);
+                }
+                for (std::size_t e = 0; e < edges.size(); ++e) {
+                    g.addEdge(edges[e].first, edges[e].second);
+                }
+            }
+            arena.release();
+        }
+        p.stop(cycles);
+    }
+
+    DefaultGraph source(ids.begin(), ids.end());
+    MonotonicArena source_arena;
+    ArenaGraph arena_source(ids.begin(), ids.end(),
+                            ArenaAllocator<int>(source_arena));
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        source.addEdge(edges[e].first, edges[e].second);
+        arena_source.addEdge(edges[e].first, edges[e].second);
+    }
+
+    {
+        Probe p("copy_destroy_default", "int", nodes, 0.1);
+        for (int c = 0; c < cycles * 10; ++c) {
+            DefaultGraph g(source);
+        }
+        p.stop(cycles * 10);
+    }
+    {
+        Probe p("copy_destroy_arena", "int", nodes, 0.1);
+        for (int c = 0; c < cycles * 10; ++c) {
+            {
+                ArenaGraph g(arena_source, ArenaAllocator<int>(arena));
+            }
+            arena.release();
+        }
+        p.stop(cycles * 10);
+    }
+}
+
+/**
+ * @brief Costo di transpose() e della trasposta mantenuta.
+ *
+ * Il grafo viene creato con il costruttore da sequenza di nodi e riceve
+ * circa due archi per nodo. Vengono misurati transpose(), l'attivazione
+ * della trasposta mantenuta e inDegree() su un nodo ogni 100 con e senza
+ * trasposta. bytes_per_op di transpose e keepTranspose riporta la memoria
+ * della matrice.
+ */
+void transposeBench(int nodes) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end());
+    for (int i = 0; i < nodes; ++i) {
+        g.addEdge(i, (i * 31 + 7) % nodes);
+        if (!g.hasEdge(i, (i + 1) % nodes)) {
+            g.addEdge(i, (i + 1) % nodes);
+        }
+    }
+    const double density = double(g.edgesNumber()) / nodes / nodes;
+
+    unsigned long total = 0;
+    {
+        Probe p("transpose", "int", nodes, density);
+        Graph t = g.transpose();
+        p.stop(1);
+        total += t.edgesNumber();
+    }
+    {
+        Probe p("inDegree_column", "int", nodes, density);
+        for (int i = 0; i < nodes; i += 100) {
+            total += g.inDegree(i);
+        }
+        p.stop(nodes / 100);
+    }
+    {
+        Probe p("keepTranspose", "int", nodes, density);
+        g.keepTranspose(true);
+        p.stop(1);
+    }
+    {
+        Probe p("inDegree_transposed", "int", nodes, density);
+        for (int i = 0; i < nodes; i += 100) {
+            total += g.inDegree(i);
+        }
+        p.stop(nodes / 100);
+    }
+
+    if (total == 0) {
+        std::cout << "transposeBench: risultati non coerenti" << std::endl;
+    }
+}
+
+/**
+ * @brief Modifiche speculative: journal contro copia e ripristino.
+ *
+ * Ogni round applica edits modifiche agli archi e riporta il grafo allo
+ * stato iniziale, con checkpoint/rollback oppure con una copia ripristinata
+ * tramite operator=. La modifica successiva alla copia duplica una fascia
+ * di righe, il ripristino condivide di nuovo la memoria.
+ */
+void journalBench(int nodes, int edits) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end());
+    const std::vector<std::pair<int, int> > edges = edgeList(nodes, 0.1);
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        g.addEdge(edges[e].first, edges[e].second);
+    }
+    const unsigned int expected = g.edgesNumber();
+    const int rounds = 100;
+    Lcg lcg(7);
+
+    {
+        g.keepJournal(true);
+        Probe p("journal_rollback", "int", nodes, 0.1);
+        for (int r = 0; r < rounds; ++r) {
+            const Graph::checkpoint_type cp = g.checkpoint();
+            for (int e = 0; e < edits; ++e) {
+                const int u = lcg.next(nodes);
+                const int v = lcg.next(nodes);
+                if (g.hasEdge(u, v)) {
+                    g.removeEdge(u, v);
+                }
+                else {
+                    g.addEdge(u, v);
+                }
+            }
+            g.rollback(cp);
+        }
+        p.stop(rounds);
+        g.keepJournal(false);
+    }
+    {
+        Probe p("copy_restore", "int", nodes, 0.1);
+        for (int r = 0; r < rounds; ++r) {
+            const Graph saved(g);
+            for (int e = 0; e < edits; ++e) {
+                const int u = lcg.next(nodes);
+                const int v = lcg.next(nodes);
+                if (g.hasEdge(u, v)) {
+                    g.removeEdge(u, v);
+                }
+                else {
+                    g.addEdge(u, v);
+                }
+            }
+            g = saved;
+        }
+        p.stop(rounds);
+    }
+
+    if (g.edgesNumber() != expected) {
+        std::cout << "journalBench: risultati non coerenti" << std::endl;
+    }
+}
+
+/**
+ * @brief Misura il conteggio di triangoli e archi reciproci con un thread
+ * e con un thread per core, confrontato con tre cicli su hasEdge.
+ */
+void cycleBench(int nodes, double density) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end());
+    const std::vector<std::pair<int, int> > edges = edgeList(nodes, density);
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        g.addEdge(edges[e].first, edges[e].second);
+    }
+
+    unsigned long long triangles = 0;
+    {
+        Probe p("count_triangles_1t", "int", nodes, density);
+        triangles = g.countTriangles(1);
+        p.stop(1);
+    }
+    {
+        Probe p("count_triangles_mt", "int", nodes, density);
+        if (g.countTriangles() != triangles) {
+            std::cout << "cycleBench: risultati non coerenti" << std::endl;
+        }
+        p.stop(1);
+    }
+    {
+        Probe p("count_reciprocal_mt", "int", nodes, density);
+        g.countReciprocalEdges();
+        p.stop(1);
+    }
+    {
+        Probe p("cycle_participation_mt", "int", nodes, density);
+        g.cycleParticipation();
+        p.stop(1);
+    }
+    if (nodes > 256) {
+        return;
+    }
+    {
+        Probe p("count_triangles_hasedge", "int", nodes, density);
+        unsigned long long count = 0;
+        for (int u = 0; u < nodes; ++u) {
+            for (int v = 0; v < nodes; ++v) {
+                if (v == u || !g.hasEdge(u, v)) {
+                    continue;
+                }
+                for (int w = 0; w < nodes; ++w) {
+                    if (w != u && w != v && g.hasEdge(v, w) &&
+                            g.hasEdge(w, u)) {
+                        ++count;
+                    }
+                }
+            }
+        }
+        if (count / 3 != triangles) {
+            std::cout << "cycleBench: risultati non coerenti" << std::endl;
+        }
+        p.stop(1);
+    }
+}
+
+/**
+ * @brief Misura un'iterazione di pageRank e hitsScores con valori double e
+ * float, su righe di bit (grafo denso) o compresse (grafo sparso).
+ */
+void rankBench(int nodes, double density) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end());
+    if (density > 0) {
+        const std::vector<std::pair<int, int> > edges =
+            edgeList(nodes, density);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            g.addEdge(edges[e].first, edges[e].second);
+        }
+    }
+    else {
+        Lcg lcg(5);
+        for (int e = 0; e < nodes * 8; ++e) {
+            g.addEdge(lcg.next(nodes), lcg.next(nodes));
+        }
+        density = double(g.edgesNumber()) / nodes / nodes;
+    }
+    g.keepTranspose(true);
+
+    const unsigned int iterations = 20;
+    {
+        Probe p("pagerank_iteration", "double", nodes, density);
+        g.pageRank(0.85, 0.0, iterations);
+        p.stop(iterations);
+    }
+    {
+        Probe p("pagerank_iteration", "float", nodes, density);
+        g.pageRank(0.85f, 0.0f, iterations);
+        p.stop(iterations);
+    }
+    {
+        std::vector<double> hubs;
+        std::vector<double> authorities;
+        Probe p("hits_iteration", "double", nodes, density);
+        g.hitsScores(hubs, authorities, 0.0, iterations);
+        p.stop(iterations);
+    }
+    if (nodes > 256) {
+        return;
+    }
+    {
+        Probe p("pagerank_hasedge", "double", nodes, density);
+        std::vector<double> rank(nodes, 1.0 / nodes);
+        for (unsigned int it = 0; it < iterations; ++it) {
+            std::vector<double> next(nodes, 0.15 / nodes);
+            for (int u = 0; u < nodes; ++u) {
+                const unsigned int degree = g.outDegree(u);
+                for (int v = 0; v < nodes; ++v) {
+                    if (degree == 0) {
+                        next[v] += 0.85 * rank[u] / nodes;
+                    }
+                    else if (g.hasEdge(u, v)) {
+                        next[v] += 0.85 * rank[u] / degree;
+                    }
+                }
+            }
+            rank.swap(next);
+        }
+        p.stop(iterations);
+    }
+}
+
+/**
+ * @brief Misura operator== tra copie condivise, copie private con i nodi
+ * nello stesso ordine e grafi con i nodi in ordine inverso, e la lettura
+ * di fingerprint.
+ */
+void equalityBench(int nodes, double density) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    const std::vector<std::pair<int, int> > edges = edgeList(nodes, density);
+    Graph g(ids.begin(), ids.end());
+    Graph reversed(ids.rbegin(), ids.rend());
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        g.addEdge(edges[e].first, edges[e].second);
+        reversed.addEdge(edges[e].first, edges[e].second);
+    }
+    const Graph shared(g);
+    Graph unshared(g);
+    for (int i = 0; i < nodes; i += 64) {
+        const bool present = unshared.hasEdge(i, i);
+        present ? unshared.removeEdge(i, i) : unshared.addEdge(i, i);
+        present ? unshared.addEdge(i, i) : unshared.removeEdge(i, i);
+    }
+
+    const int rounds = 100;
+    int equal = 0;
+    {
+        Probe p("equal_shared", "int", nodes, density);
+        for (int r = 0; r < rounds; ++r) {
+            equal += (g == shared) ? 1 : 0;
+        }
+        p.stop(rounds);
+    }
+    {
+        Probe p("equal_memcmp", "int", nodes, density);
+        for (int r = 0; r < rounds; ++r) {
+            equal += (g == unshared) ? 1 : 0;
+        }
+        p.stop(rounds);
+    }
+    {
+        Probe p("equal_reordered", "int", nodes, density);
+        equal += (g == reversed) ? 1 : 0;
+        p.stop(1);
+    }
+    {
+        Probe p("fingerprint", "int", nodes, density);
+        unsigned long long sum = 0;
+        for (int r = 0; r < rounds; ++r) {
+            sum += g.fingerprint();
+        }
+        equal += (sum == 0) ? 1 : 0;
+        p.stop(rounds);
+    }
+
+    if (equal != 2 * rounds + 1) {
+        std::cout << "equalityBench: risultati non coerenti" << std::endl;
+    }
+}
+
+/**
+ * @brief Misura dominatorTree e 10^6 interrogazioni dominates su un grafo
+ * con un cammino 0 -> 1 -> ... e tre archi casuali per nodo.
+ */
+void dominatorBench(int nodes) {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end());
+    Lcg lcg(13);
+    for (int i = 0; i + 1 < nodes; ++i) {
+        g.addEdge(i, i + 1);
+    }
+    for (int e = 0; e < nodes * 3; ++e) {
+        const int u = lcg.next(nodes);
+        const int v = lcg.next(nodes);
+        if (!g.hasEdge(u, v)) {
+            g.addEdge(u, v);
+        }
+    }
+    const double density = double(g.edgesNumber()) / nodes / nodes;
+
+    DominatorTree tree;
+    {
+        Probe p("dominator_tree", "int", nodes, density);
+        tree = g.dominatorTree(0);
+        p.stop(1);
+    }
+    {
+        const unsigned int queries = 1000000;
+        unsigned int found = 0;
+        Probe p("dominates", "int", nodes, density);
+        for (unsigned int q = 0; q < queries; ++q) {
+            found += tree.dominates(lcg.next(nodes), lcg.next(nodes)) ? 1 : 0;
+        }
+        p.stop(queries);
+        if (found == 0) {
+            std::cout << "dominatorBench: risultati non coerenti" << std::endl;
+        }
+    }
+}
+
+#ifdef MAPPED_ARENA_AVAILABLE
+/**
+ * @brief Misura gli accessi a freddo a un grafo su file mappato.
+ *
+ * Prima di ogni misura le pagine vengono scaricate sul file, quindi le
+ * colonne minflt_per_op e majflt_per_op contano le pagine rilette da ogni
+ * tipo di accesso: scansione delle righe in ordine, con e senza modalità
+ * sequenziale, righe casuali, con e senza prefetch dei nodi successivi, e
+ * colonne, con e senza trasposta mantenuta.
+ */
+void mappedBench(int nodes) {
+    typedef Digraph<int, Int_equal, MappedAllocator<int> > Graph;
+
+    const std::size_t matrix = std::size_t(nodes) * bitWords(nodes) *
+                               sizeof(bit_word);
+    MappedArena arena(".", 2 * matrix + (1 << 20));
+
+    std::vector<int> ids;
+    for (int i = 0; i < nodes; ++i) {
+        ids.push_back(i);
+    }
+    Graph g(ids.begin(), ids.end(), MappedAllocator<int>(arena));
+    Lcg lcg(11);
+    for (int e = 0; e < nodes * 16; ++e) {
+        g.addEdge(lcg.next(nodes), lcg.next(nodes));
+    }
+    const double density = double(g.edgesNumber()) / nodes / nodes;
+
+    const unsigned int rows = 2000;
+    std::vector<int> random_rows;
+    for (unsigned int r = 0; r < rows; ++r) {
+        random_rows.push_back(lcg.next(nodes));
+    }
+    const unsigned int columns = 100;
+    const unsigned int ahead = 8;
+    unsigned long long sum = 0;
+
+    arena.evict();
+    {
+        Probe p("mapped_row_scan", "int", nodes, density);
+        for (int i = 0; i < nodes; ++i) {
+            sum += g.outDegree(i);
+        }
+        p.stop(nodes);
+    }
+    arena.evict();
+    {
+        g.sequentialScan(true);
+        Probe p("mapped_row_scan_seq", "int", nodes, density);
+        for (int i = 0; i < nodes; ++i) {
+            sum += g.outDegree(i);
+        }
+        p.stop(nodes);
+        g.sequentialScan(false);
+    }
+    arena.evict();
+    {
+        Probe p("mapped_random_rows", "int", nodes, density);
+        for (unsigned int r = 0; r < rows; ++r) {
+            sum += g.outDegree(random_rows[r]);
+        }
+        p.stop(rows);
+    }
+    arena.evict();
+    {
+        Probe p("mapped_random_rows_prefetch", "int", nodes, density);
+        for (unsigned int r = 0; r < ahead && r < rows; ++r) {
+            g.prefetch(random_rows[r]);
+        }
+        for (unsigned int r = 0; r < rows; ++r) {
+            if (r + ahead < rows) {
+                g.prefetch(random_rows[r + ahead]);
+            }
+            sum += g.outDegree(random_rows[r]);
+        }
+        p.stop(rows);
+    }
+    arena.evict();
+    {
+        Probe p("mapped_column", "int", nodes, density);
+        for (unsigned int c = 0; c < columns; ++c) {
+            sum += g.inDegree(random_rows[c]);
+        }
+        p.stop(columns);
+    }
+    g.keepTranspose(true);
+    arena.evict();
+    {
+        Probe p("mapped_column_transpose", "int", nodes, density);
+        for (unsigned int c = 0; c < columns; ++c) {
+            sum += g.inDegree(random_rows[c]);
+        }
+        p.stop(columns);
+    }
+
+    if (sum == 0) {
+        std::cout << "mappedBench: risultati non coerenti" << std::endl;
+    }
+}
+#endif
+
+int main() {
+    std::cout << "bench,type,nodes,density,ops,ns_per_op,allocs_per_op,"
+              << "bytes_per_op,peak_rss_kb,minflt_per_op,majflt_per_op\n";
+
+    const int sizes[] = {64, 256, 1024};
+    const double densities[] = {0.01, 0.1, 0.5};
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(*sizes); ++s) {
+        for (unsigned int d = 0; d < sizeof(densities) / sizeof(*densities);
+                ++d) {
+            operationsBench<int, Int_equal>(sizes[s], densities[d]);
+            operationsBench<Person, Person_equal>(sizes[s], densities[d]);
+        }
+    }
+
+    allocatorBench(64, 50);
+    allocatorBench(256, 5);
+    transposeBench(20000);
+    journalBench(1024, 10);
+    cycleBench(256, 0.1);
+    cycleBench(4096, 0.01);
+    rankBench(256, 0.1);
+    rankBench(4096, 0.3);
+    rankBench(20000, 0);
+    equalityBench(1024, 0.1);
+#ifdef MAPPED_ARENA_AVAILABLE
+    mappedBench(20000);
+#endif
+    dominatorBench(20000);
+    dominatorBench(100000);
+
+    return 0;
+}
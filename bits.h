@@ -0,0 +1,375 @@
+#ifndef bits_h
+#define bits_h
+
+#include <cstdint> // std::uint64_t
+#include <cstddef> // std::size_t
+#if defined(__BMI2__)
+#include <immintrin.h> // _pext_u64
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h> // _mm_add_pd _mm_add_ps _mm_and_pd _mm_and_ps
+#endif
+
+
+/**
+ * @brief constexpr per le funzioni che lo ammettono solo da C++14.
+ *
+ * Con standard precedenti le funzioni vengono dichiarate inline.
+ */
+#if __cplusplus >= 201402L
+#define BITS_CONSTEXPR constexpr
+#else
+#define BITS_CONSTEXPR inline
+#endif
+
+/**
+ * @brief Parola usata per memorizzare righe di bit.
+ *
+ * Il bit j di una riga si trova nella parola j / 64, in posizione j % 64.
+ */
+typedef std::uint64_t bit_word;
+
+/**
+ * @brief Numero di bit in una bit_word.
+ */
+const unsigned int BIT_WORD_BITS = 64;
+
+/**
+ * @brief Numero di parole necessarie per memorizzare bits bit.
+ */
+BITS_CONSTEXPR unsigned int bitWords(unsigned int bits) {
+    return (bits + BIT_WORD_BITS - 1) / BIT_WORD_BITS;
+}
+
+/**
+ * @brief Numero di bit a 1 nella parola.
+ */
+BITS_CONSTEXPR unsigned int bitCount(bit_word w) {
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_popcountll(w));
+#else
+    unsigned int count = 0;
+    for (; w != 0; w &= w - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Posizione del bit a 1 meno significativo.
+ *
+ * @pre w != 0
+ */
+BITS_CONSTEXPR unsigned int lowestBit(bit_word w) {
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctzll(w));
+#else
+    unsigned int pos = 0;
+    while ((w & 1) == 0) {
+        w >>= 1;
+        ++pos;
+    }
+    return pos;
+#endif
+}
+
+/**
+ * @brief Legge il bit in posizione pos della riga.
+ */
+BITS_CONSTEXPR bool testBit(const bit_word* row, unsigned int pos) {
+    return (row[pos / BIT_WORD_BITS] >> (pos % BIT_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Inverte il bit in posizione pos della riga.
+ */
+BITS_CONSTEXPR void flipBit(bit_word* row, unsigned int pos) {
+    row[pos / BIT_WORD_BITS] ^= bit_word(1) << (pos % BIT_WORD_BITS);
+}
+
+/**
+ * @brief Numero di bit a 1 in una riga di words parole.
+ */
+BITS_CONSTEXPR unsigned int rowCount(const bit_word* row, unsigned int words) {
+    unsigned int count = 0;
+    for (unsigned int w = 0; w < words; ++w) {
+        count += bitCount(row[w]);
+    }
+    return count;
+}
+
+/**
+ * @brief Mescola i bit di x (finalizzatore di splitmix64).
+ *
+ * Ogni bit del risultato dipende da tutti i bit di x, quindi somme di
+ * valori mescolati possono essere usate come hash di multinsiemi.
+ */
+BITS_CONSTEXPR std::uint64_t mixBits(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Estrae i bit di w selezionati da mask e li compatta in basso.
+ *
+ * Equivale all'istruzione PEXT, che viene usata se il compilatore la rende
+ * disponibile (ad esempio con -mbmi2 o -march=native).
+ */
+inline bit_word extractBits(bit_word w, bit_word mask) {
+#if defined(__BMI2__)
+    return _pext_u64(w, mask);
+#else
+    bit_word result = 0;
+    bit_word out = 1;
+    for (; mask != 0; mask &= mask - 1, out <<= 1) {
+        if (w & mask & (~mask + 1)) {
+            result |= out;
+        }
+    }
+    return result;
+#endif
+}
+
+/**
+ * @brief Raccoglie in dst i bit di src selezionati da mask.
+ *
+ * I bit selezionati vengono scritti in dst consecutivamente, mantenendo
+ * l'ordine originale.
+ *
+ * @param src Riga sorgente di words parole.
+ * @param mask Maschera di selezione di words parole.
+ * @param words Numero di parole di src e mask.
+ * @param dst Riga destinazione azzerata.
+ */
+inline void gatherBits(const bit_word* src, const bit_word* mask,
+        unsigned int words, bit_word* dst) {
+    unsigned int pos = 0;
+    for (unsigned int w = 0; w < words; ++w) {
+        if (mask[w] == 0) {
+            continue;
+        }
+        const bit_word bits = extractBits(src[w], mask[w]);
+        const unsigned int shift = pos % BIT_WORD_BITS;
+
+        dst[pos / BIT_WORD_BITS] |= bits << shift;
+        if (shift != 0 && shift + bitCount(mask[w]) > BIT_WORD_BITS) {
+            dst[pos / BIT_WORD_BITS + 1] |= bits >> (BIT_WORD_BITS - shift);
+        }
+        pos += bitCount(mask[w]);
+    }
+}
+
+/**
+ * @brief Bit a 1 da cui conviene sommare una parola con maskedSum invece
+ * di scorrerne i bit con lowestBit.
+ */
+const unsigned int MASKED_SUM_MIN_BITS = 16;
+
+/**
+ * @brief Somma dei valori x[b] per cui il bit b di word è a 1.
+ *
+ * Somma tutti i 64 valori azzerando quelli non selezionati, senza salti.
+ * Per float e double, se SSE2 è disponibile, vengono sommati quattro float
+ * o due double per istruzione.
+ *
+ * @param x Array di almeno 64 valori.
+ * @param word Maschera dei valori da sommare.
+ */
+template <typename V>
+inline V maskedSum(const V* x, bit_word word) {
+    V acc[4] = {V(0), V(0), V(0), V(0)};
+    for (unsigned int b = 0; b < BIT_WORD_BITS; ++b) {
+        acc[b % 4] += ((word >> b) & 1) ? x[b] : V(0);
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief maskedSum per double: due valori per istruzione.
+ */
+inline double maskedSum(const double* x, bit_word word) {
+    static const long long masks[4][2] = {
+        {0, 0}, {-1, 0}, {0, -1}, {-1, -1}
+    };
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (unsigned int b = 0; b < BIT_WORD_BITS; b += 4, word >>= 4) {
+        const __m128d m0 = _mm_castsi128_pd(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(masks[word & 3])));
+        const __m128d m1 = _mm_castsi128_pd(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(masks[(word >> 2) & 3])));
+        acc0 = _mm_add_pd(acc0, _mm_and_pd(_mm_loadu_pd(x + b), m0));
+        acc1 = _mm_add_pd(acc1, _mm_and_pd(_mm_loadu_pd(x + b + 2), m1));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1];
+}
+
+/**
+ * @brief maskedSum per float: quattro valori per istruzione.
+ */
+inline float maskedSum(const float* x, bit_word word) {
+    static const int masks[16][4] = {
+        {0, 0, 0, 0}, {-1, 0, 0, 0}, {0, -1, 0, 0}, {-1, -1, 0, 0},
+        {0, 0, -1, 0}, {-1, 0, -1, 0}, {0, -1, -1, 0}, {-1, -1, -1, 0},
+        {0, 0, 0, -1}, {-1, 0, 0, -1}, {0, -1, 0, -1}, {-1, -1, 0, -1},
+        {0, 0, -1, -1}, {-1, 0, -1, -1}, {0, -1, -1, -1}, {-1, -1, -1, -1}
+    };
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (unsigned int b = 0; b < BIT_WORD_BITS; b += 8, word >>= 8) {
+        const __m128 m0 = _mm_castsi128_ps(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(masks[word & 15])));
+        const __m128 m1 = _mm_castsi128_ps(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(masks[(word >> 4) & 15])));
+        acc0 = _mm_add_ps(acc0, _mm_and_ps(_mm_loadu_ps(x + b), m0));
+        acc1 = _mm_add_ps(acc1, _mm_and_ps(_mm_loadu_ps(x + b + 4), m1));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+/**
+ * @brief Copia in dst la riga src privata del bit in posizione pos.
+ *
+ * I bit successivi a pos vengono spostati indietro di una posizione.
+ * src e dst possono coincidere: ogni parola viene scritta dopo aver letto
+ * quelle da cui dipende.
+ *
+ * @param src Riga sorgente di bits bit.
+ * @param dst Riga destinazione di bitWords(bits - 1) parole.
+ * @param bits Numero di bit validi in src.
+ * @param pos Bit da rimuovere.
+ */
+BITS_CONSTEXPR void copyRemovingBit(const bit_word* src, bit_word* dst,
+        unsigned int bits, unsigned int pos) {
+    const unsigned int dst_words = bitWords(bits - 1);
+    const unsigned int split = pos / BIT_WORD_BITS;
+    const bit_word low = (bit_word(1) << (pos % BIT_WORD_BITS)) - 1;
+
+    for (unsigned int w = 0; w < split; ++w) {
+        dst[w] = src[w];
+    }
+    for (unsigned int w = split; w < dst_words; ++w) {
+        bit_word word = (w == split) ?
+            (src[w] & low) | ((src[w] >> 1) & ~low) : (src[w] >> 1);
+        if (w + 1 < bitWords(bits)) {
+            word |= src[w + 1] << (BIT_WORD_BITS - 1);
+        }
+        dst[w] = word;
+    }
+}
+
+/**
+ * @brief Copia in dst la riga src inserendo un bit a 0 in posizione pos.
+ *
+ * I bit da pos in poi vengono spostati avanti di una posizione, è
+ * l'operazione inversa di copyRemovingBit.
+ *
+ * @param src Riga sorgente di bits bit.
+ * @param dst Riga destinazione di bitWords(bits + 1) parole.
+ * @param bits Numero di bit validi in src.
+ * @param pos Posizione del bit da inserire, pos <= bits.
+ */
+BITS_CONSTEXPR void copyInsertingBit(const bit_word* src, bit_word* dst,
+        unsigned int bits, unsigned int pos) {
+    const unsigned int src_words = bitWords(bits);
+    const unsigned int dst_words = bitWords(bits + 1);
+    const unsigned int split = pos / BIT_WORD_BITS;
+    const bit_word low = (bit_word(1) << (pos % BIT_WORD_BITS)) - 1;
+
+    for (unsigned int w = 0; w < split; ++w) {
+        dst[w] = src[w];
+    }
+    for (unsigned int w = split; w < dst_words; ++w) {
+        const bit_word word = (w < src_words) ? src[w] : 0;
+        dst[w] = (w == split) ? (word & low) | ((word & ~low) << 1) :
+                                (word << 1) |
+                                (src[w - 1] >> (BIT_WORD_BITS - 1));
+    }
+}
+
+/**
+ * @brief Trasposizione in place di un blocco di 64x64 bit.
+ *
+ * Il bit c della parola r viene scambiato con il bit r della parola c.
+ * Ad ogni passo vengono scambiati in parallelo i sotto-blocchi fuori
+ * diagonale di dimensione j, quindi il costo è 6 * 32 operazioni su parole.
+ */
+BITS_CONSTEXPR void transposeBlock(bit_word block[64]) {
+    bit_word mask = 0x00000000FFFFFFFFULL;
+    for (unsigned int j = 32; j != 0; j >>= 1, mask ^= (mask << j)) {
+        for (unsigned int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            bit_word t = ((block[k] >> j) ^ block[k | j]) & mask;
+            block[k] ^= t << j;
+            block[k | j] ^= t;
+        }
+    }
+}
+
+/**
+ * @brief Trasposta di una matrice di bit n x n memorizzata per righe.
+ *
+ * La matrice è divisa in fasce di 64 righe consecutive, ognuna contigua in
+ * memoria; per una matrice contigua la fascia b inizia alla riga b * 64.
+ * La matrice viene elaborata a blocchi di 64x64 bit: ogni blocco viene
+ * letto da 64 righe consecutive, trasposto nei registri e scritto su 64
+ * righe consecutive della destinazione. I blocchi sono raggruppati in
+ * tessere di 8x8 blocchi, così ogni linea di cache della sorgente e della
+ * destinazione viene letta o scritta per intero una sola volta.
+ * I blocchi privi di bit a 1 vengono saltati.
+ *
+ * @param src Fasce della matrice sorgente, righe di bitWords(n) parole.
+ * @param dst Fasce della matrice destinazione azzerata, righe di
+ * bitWords(n) parole.
+ * @param n Dimensione della matrice.
+ */
+inline void transposeMatrix(const bit_word* const* src,
+        bit_word* const* dst, unsigned int n) {
+    const unsigned int words = bitWords(n);
+    const unsigned int tile = 8;
+    bit_word block[64];
+
+    for (unsigned int ti = 0; ti < words; ti += tile) {
+        const unsigned int ti_end = (words - ti < tile) ? words : ti + tile;
+        for (unsigned int tj = 0; tj < words; tj += tile) {
+            const unsigned int tj_end = (words - tj < tile) ? words : tj + tile;
+
+            for (unsigned int bi = ti; bi < ti_end; ++bi) {
+                const unsigned int rows = (n - bi * 64 < 64) ?
+                                          n - bi * 64 : 64;
+                for (unsigned int bj = tj; bj < tj_end; ++bj) {
+                    const unsigned int cols = (n - bj * 64 < 64) ?
+                                              n - bj * 64 : 64;
+
+                    bit_word any = 0;
+                    for (unsigned int r = 0; r < rows; ++r) {
+                        block[r] = src[bi][std::size_t(r) * words + bj];
+                        any |= block[r];
+                    }
+                    if (any == 0) {
+                        continue; // Blocco vuoto, dst è già azzerata
+                    }
+                    for (unsigned int r = rows; r < 64; ++r) {
+                        block[r] = 0;
+                    }
+
+                    transposeBlock(block);
+
+                    for (unsigned int c = 0; c < cols; ++c) {
+                        dst[bj][std::size_t(c) * words + bi] = block[c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif //bits_h
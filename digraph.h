@@ -1,12 +1,175 @@
 #ifndef digraph_h
 #define digraph_h
 
-#include <algorithm> // std::swap
+#include <algorithm> // std::swap std::min std::copy
+#include <cmath> // std::abs std::sqrt
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcmp
+#include <functional> // std::hash
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <mutex> // std::mutex std::lock_guard std::unique_lock
+#include <new> // placement new
+#include <memory> // std::allocator std::allocator_traits
+#include <type_traits> // std::true_type std::false_type
 #include <iterator> // std::forward_iterator_tag
 #include <cstddef> // std::ptrdiff_t
 #include <cassert> // assert
 #include <ostream> // std::ostream
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <vector> // std::vector
+#include <utility> // std::pair std::make_pair std::move
+#include <thread> // std::thread
 
+#include "bits.h"
+#include "stats.h"
+
+
+/**
+ * @brief Cicli brevi a cui partecipa un nodo, calcolati da
+ * Digraph::cycleParticipation.
+ */
+struct CycleCounts {
+    unsigned long long triangles; ///< Cicli orientati u -> v -> w -> u
+    unsigned int reciprocal; ///< Nodi v != u con archi u -> v e v -> u
+
+    CycleCounts() : triangles(0), reciprocal(0) {}
+};
+
+/**
+ * @brief Albero dei dominatori di un grafo con radice, calcolato da
+ * Digraph::dominatorTree.
+ *
+ * I nodi sono indicati dalla loro posizione nell'ordine degli iteratori del
+ * grafo. Il nodo a domina b se ogni cammino dalla radice a b passa per a;
+ * il dominatore immediato di b è il suo dominatore stretto più vicino, e
+ * i dominatori immediati formano un albero con radice root().
+ * L'albero viene visitato una volta alla costruzione, così dominates
+ * risponde in O(1) confrontando gli intervalli di visita.
+ */
+class DominatorTree {
+    std::vector<unsigned int> _idom; ///< Dominatori immediati
+    std::vector<unsigned int> _enter; ///< Ingresso nella visita dell'albero
+    std::vector<unsigned int> _exit; ///< Uscita dalla visita dell'albero
+    unsigned int _root; ///< Radice
+
+public:
+    enum { NONE = ~0u }; ///< Posizione non valida
+
+    /**
+     * @brief Costruttore di un albero vuoto.
+     */
+    DominatorTree() : _root(NONE) {}
+
+    /**
+     * @brief Costruttore da un vettore di dominatori immediati.
+     *
+     * @param root Posizione della radice.
+     * @param idom Dominatore immediato di ogni nodo, NONE per la radice e
+     * per i nodi non raggiungibili.
+     * @pre root < idom.size() e idom[root] == NONE
+     */
+    DominatorTree(unsigned int root, std::vector<unsigned int> idom) :
+            _enter(idom.size(), NONE), _exit(idom.size(), NONE),
+            _root(root) {
+        assert(root < idom.size() && idom[root] == NONE);
+        _idom.swap(idom);
+
+        // Figli di ogni nodo in formato compresso
+        const unsigned int n = static_cast<unsigned int>(_idom.size());
+        std::vector<unsigned int> first(n + 1, 0);
+        for (unsigned int i = 0; i < n; ++i) {
+            if (_idom[i] != NONE) {
+                ++first[_idom[i] + 1];
+            }
+        }
+        for (unsigned int i = 0; i < n; ++i) {
+            first[i + 1] += first[i];
+        }
+        std::vector<unsigned int> children(first[n]);
+        std::vector<unsigned int> next(first.begin(), first.end() - 1);
+        for (unsigned int i = 0; i < n; ++i) {
+            if (_idom[i] != NONE) {
+                children[next[_idom[i]]++] = i;
+            }
+        }
+
+        // Visita iterativa, next[u] è il prossimo figlio da visitare
+        std::copy(first.begin(), first.end() - 1, next.begin());
+        std::vector<unsigned int> stack(1, root);
+        unsigned int clock = 0;
+        _enter[root] = clock++;
+        while (!stack.empty()) {
+            const unsigned int u = stack.back();
+            if (next[u] == first[u + 1]) {
+                _exit[u] = clock++;
+                stack.pop_back();
+                continue;
+            }
+            const unsigned int c = children[next[u]++];
+            _enter[c] = clock++;
+            stack.push_back(c);
+        }
+    }
+
+    /**
+     * @brief Numero di nodi del grafo.
+     */
+    unsigned int size() const {
+        return static_cast<unsigned int>(_idom.size());
+    }
+
+    /**
+     * @brief Posizione della radice, NONE per un albero vuoto.
+     */
+    unsigned int root() const {
+        return _root;
+    }
+
+    /**
+     * @brief Ritorna true se il nodo i è raggiungibile dalla radice.
+     *
+     * @pre i < size()
+     */
+    bool reachable(unsigned int i) const {
+        assert(i < size());
+        return _enter[i] != NONE;
+    }
+
+    /**
+     * @brief Dominatore immediato del nodo i.
+     *
+     * @pre i < size()
+     * @return Posizione del dominatore immediato, NONE per la radice e per
+     * i nodi non raggiungibili.
+     */
+    unsigned int immediateDominator(unsigned int i) const {
+        assert(i < size());
+        return _idom[i];
+    }
+
+    /**
+     * @brief Dominatori immediati di tutti i nodi, come immediateDominator.
+     */
+    const std::vector<unsigned int>& immediateDominators() const {
+        return _idom;
+    }
+
+    /**
+     * @brief Ritorna true se a domina b, costo O(1).
+     *
+     * Ogni nodo raggiungibile domina se stesso; i nodi non raggiungibili
+     * non dominano e non sono dominati.
+     *
+     * @pre a < size() e b < size()
+     */
+    bool dominates(unsigned int a, unsigned int b) const {
+        assert(a < size() && b < size());
+        return reachable(a) && reachable(b) && _enter[a] <= _enter[b] &&
+               _exit[b] <= _exit[a];
+    }
+};
 
 /**
  * @brief Grafo orientato contenente nodi di tipo T.
@@ -15,18 +178,155 @@
  * Gli archi vengono memorizzati tramite matrice di adiacenza.
  * L'uguaglianza tra due dati di tipo T è verificata usando un funtore di
  * uguaglianza E.
+ * Tutta la memoria (identificativi e matrice di adiacenza) viene ottenuta
+ * dall'allocatore A, eventualmente con stato (arena, memory resource).
+ * Le copie condividono gli identificativi e le fasce della matrice tramite
+ * un contatore di riferimenti; una fascia viene duplicata solo alla prima
+ * modifica (copy-on-write).
  * 
  * @param T tipo dei nodi
- * @param E funtore di uguaglianza tra due nodi
+ * @param E funtore di uguaglianza tra due nodi; può fornire un metodo
+ *  hash(const T&) coerente, usato da fingerprint()
+ * @param A allocatore, deve soddisfare i requisiti Allocator per il tipo T
+ * @param S policy delle statistiche, NoDigraphStats (nessun costo) o
+ * DigraphStats
  */
-template <typename T, typename E>
-class Digraph {
+template <typename T, typename E, typename A = std::allocator<T>,
+          typename S = NoDigraphStats>
+class Digraph : private S {
+    typedef std::allocator_traits<A> node_traits;
+    typedef typename node_traits::template rebind_alloc<bit_word>
+        matrix_alloc_type;
+    typedef std::allocator_traits<matrix_alloc_type> matrix_traits;
+    typedef typename node_traits::template rebind_alloc<bit_word*>
+        table_alloc_type;
+    typedef std::allocator_traits<table_alloc_type> table_traits;
+
+    /**
+     * @brief Contatore dei Digraph che condividono un blocco di memoria.
+     */
+    typedef std::atomic<std::size_t> ref_count;
+
+    static_assert(sizeof(ref_count) <= sizeof(bit_word) &&
+                  alignof(ref_count) <= alignof(bit_word),
+                  "il contatore deve stare in una bit_word");
+
     T* _nodes; ///< Puntatore ad array contenente gli identificativi dei nodi
+    ref_count* _nodes_refs; ///< Digraph che condividono _nodes e nodeHashes
     unsigned int _nodes_number; ///< Numero di nodi
-    bool** _adj_matrix; ///< Matrice di adiacenza
+    unsigned int _row_words; ///< Parole per riga della matrice
+    bit_word** _adj_matrix; ///< Fasce della matrice di adiacenza
+    bit_word** _adj_transpose; ///< Fasce della trasposta, nullptr se assente
+    bool _keep_transpose; ///< true se la trasposta deve essere mantenuta
     unsigned int _edges_number; ///< Numero di archi
+    std::uint64_t _fingerprint; ///< Somma dei contributi di fingerprint()
+
+    /**
+     * @brief Tipo di modifica registrata nel journal.
+     */
+    enum JournalOp {
+        EDGE_ADDED, ///< addEdge
+        EDGE_REMOVED, ///< removeEdge
+        NODE_ADDED, ///< addNode
+        NODE_REMOVED ///< removeNode
+    };
+
+    /**
+     * @brief Modifica registrata nel journal.
+     * 
+     * Nodi e archi sono indicati per posizione, valida nello stato del grafo
+     * in cui la modifica viene applicata.
+     */
+    struct JournalEntry {
+        JournalOp op; ///< Tipo di modifica
+        unsigned int u; ///< Sorgente dell'arco o posizione del nodo
+        unsigned int v; ///< Destinazione dell'arco
+        unsigned int out; ///< Successori salvati del nodo rimosso
+        unsigned int in; ///< Predecessori salvati del nodo rimosso
+        std::size_t node; ///< Posizione del nodo in Journal::nodes
+        std::size_t links; ///< Posizione dei vicini in Journal::links
+    };
+
+    typedef typename node_traits::template rebind_alloc<JournalEntry>
+        entry_alloc_type;
+    typedef typename node_traits::template rebind_alloc<unsigned int>
+        index_alloc_type;
+
+    /**
+     * @brief Journal delle modifiche, allocato solo se richiesto.
+     * 
+     * Le voci successive a position sono modifiche annullate che possono
+     * essere riapplicate con redo. Per i nodi rimossi vengono salvate solo
+     * le posizioni dei vicini, in un unico vettore condiviso da tutte le
+     * voci.
+     */
+    struct Journal {
+        A alloc; ///< Allocatore con cui è stato allocato il journal
+        std::vector<JournalEntry, entry_alloc_type> entries; ///< Modifiche
+        std::vector<T, A> nodes; ///< Nodi aggiunti o rimossi
+        std::vector<unsigned int, index_alloc_type> links; ///< Vicini
+        std::size_t position; ///< Numero di modifiche applicate
+
+        explicit Journal(const A& a) : alloc(a),
+                entries(entry_alloc_type(a)), nodes(a),
+                links(index_alloc_type(a)), position(0) {}
+    };
+
+    typedef typename node_traits::template rebind_alloc<Journal>
+        journal_alloc_type;
+    typedef std::allocator_traits<journal_alloc_type> journal_traits;
 
     E _equal;  ///< Istanza del funtore di uguaglianza
+    A _alloc;  ///< Istanza dell'allocatore
+    Journal* _journal; ///< Journal delle modifiche, nullptr se disattivato
+
+    static const unsigned int NONE = ~0u; ///< Posizione non valida
+    static const unsigned int BAND_ROWS = 64; ///< Righe per fascia
+    /// Contributo di un cappio a _fingerprint
+    static const std::uint64_t LOOP_TERM = 0x8A5CD789635D2DFFULL;
+    /// Contributo di una coppia di archi opposti a _fingerprint
+    static const std::uint64_t RECIPROCAL_TERM = 0x121FD2155C472F96ULL;
+    /// Moltiplicatore dell'hash della sorgente nel contributo di un arco
+    static const std::uint64_t EDGE_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+    /// Distingue il contributo di un nodo da quello di un arco
+    static const std::uint64_t NODE_TERM = 0xD6E8FEB86659FD93ULL;
+
+    template <typename U, typename F, typename B, typename P>
+    friend std::ostream& operator<<(std::ostream& os,
+        const Digraph<U,F,B,P>& digraph);
+    template <typename U, typename F, typename B, typename P>
+    friend std::ostream& writeEdgeList(std::ostream& os,
+        const Digraph<U,F,B,P>& digraph);
+    template <typename U, typename F, typename B, typename P>
+    friend std::ostream& writeDot(std::ostream& os,
+        const Digraph<U,F,B,P>& digraph);
+    template <typename U, typename F, typename B, typename P>
+    friend std::ostream& writeMatrixMarket(std::ostream& os,
+        const Digraph<U,F,B,P>& digraph);
+    template <typename U, typename F, typename B, typename P>
+    friend bool operator==(const Digraph<U,F,B,P>& a,
+        const Digraph<U,F,B,P>& b);
+    template <typename U, typename F, typename B, typename P>
+    friend Digraph<U,F,B,P> graphUnion(const Digraph<U,F,B,P>& a,
+        const Digraph<U,F,B,P>& b);
+    template <typename U, typename F, typename B, typename P>
+    friend Digraph<U,F,B,P> graphIntersection(const Digraph<U,F,B,P>& a,
+        const Digraph<U,F,B,P>& b);
+    template <typename U, typename F, typename B, typename P>
+    friend Digraph<U,F,B,P> graphDifference(const Digraph<U,F,B,P>& a,
+        const Digraph<U,F,B,P>& b);
+    template <typename U, typename F, typename B, typename P>
+    friend Digraph<U,F,B,P> symmetricDifference(const Digraph<U,F,B,P>& a,
+        const Digraph<U,F,B,P>& b);
+
+    /**
+     * @brief Insieme dei nodi del risultato di un'operazione tra grafi.
+     */
+    enum NodeSet {
+        NODES_UNION, ///< Nodi del primo grafo seguiti dai nuovi del secondo
+        NODES_COMMON, ///< Nodi presenti in entrambi, nell'ordine del primo
+        NODES_FIRST ///< Nodi del primo grafo
+    };
 
     /**
      * @brief Costruttore che inizializza un Digraph di dimensione specificata.
@@ -34,341 +334,2514 @@ class Digraph {
      * Costruttore PRIVATE che inizializza un Digraph avente il numero di nodi
      * specificato e privo di archi.
      * 
-     * Il chiamante DEVE occuparsi dell'inizializzazione di _nodes
+     * Il chiamante DEVE occuparsi dell'inizializzazione di _nodes, che
+     * contiene nodes_number identificativi costruiti di default, tramite
+     * setNode o copyNode, e di aggiungere a _fingerprint i contributi dei
+     * nodi e degli archi.
      * 
      * @param nodes_number Numero di nodi.
+     * @param alloc Allocatore da cui ottenere la memoria.
+     * @param transpose true se deve essere allocata anche la trasposta.
      * @post _nodes_number == nodes_number
      * @post _edges_number == 0
      * @throw eccezione di allocazione della memoria
      */
-    explicit Digraph(const unsigned int& nodes_number) : _nodes(nullptr),
-            _nodes_number(0), _adj_matrix(nullptr), _edges_number(0) {
+    Digraph(const unsigned int& nodes_number, const A& alloc,
+            bool transpose = false) : _nodes(nullptr), _nodes_refs(nullptr),
+            _nodes_number(0), _row_words(0), _adj_matrix(nullptr),
+            _adj_transpose(nullptr), _keep_transpose(transpose),
+            _edges_number(0), _fingerprint(0), _alloc(alloc),
+            _journal(nullptr) {
         
         if (nodes_number == 0) {
             return;
         }
 
-        try {
-            _nodes = new T[nodes_number];
+        unsigned int constructed = 0;
+        matrix_alloc_type matrix_alloc(_alloc);
 
-            _adj_matrix = new bool*[nodes_number];
-            for (unsigned int i = 0; i < nodes_number; ++i) {
-                _adj_matrix[i] = nullptr;
+        try {
+            _nodes = node_traits::allocate(_alloc, nodes_number);
+            for (; constructed < nodes_number; ++constructed) {
+                node_traits::construct(_alloc, _nodes + constructed);
             }
-            for (unsigned int i = 0; i < nodes_number; ++i) {
-                _adj_matrix[i] = new bool[nodes_number];
+            _nodes_refs = ::new (static_cast<void*>(matrix_traits::allocate(
+                matrix_alloc, nodes_number + 1))) ref_count(1);
+
+            _adj_matrix = allocateMatrix(nodes_number);
+            if (transpose) {
+                _adj_transpose = allocateMatrix(nodes_number);
             }
         } catch(...) {
-            clear();
+            deallocateMatrix(_adj_matrix, nodes_number);
+            _adj_matrix = nullptr;
+            if (_nodes_refs != nullptr) {
+                matrix_traits::deallocate(matrix_alloc,
+                    reinterpret_cast<bit_word*>(_nodes_refs),
+                    nodes_number + 1);
+                _nodes_refs = nullptr;
+            }
+            if (_nodes != nullptr) {
+                for (unsigned int i = 0; i < constructed; ++i) {
+                    node_traits::destroy(_alloc, _nodes + i);
+                }
+                node_traits::deallocate(_alloc, _nodes, nodes_number);
+                _nodes = nullptr;
+            }
             throw;
         }
 
         _nodes_number = nodes_number;
-        for (unsigned int i = 0; i < nodes_number; ++i) {
-            for (unsigned int j = 0; j < nodes_number; ++j) {
-                _adj_matrix[i][j] = false;
+        _row_words = bitWords(nodes_number);
+        _fingerprint = nodes_number * mixBits(0);
+        S::countAllocated(nodes_number * (sizeof(T) + sizeof(bit_word)) +
+                          matrixBytes() * (transpose ? 2 : 1));
+    }
+
+    /**
+     * @brief Hash dei nodi, nella stessa posizione in _nodes.
+     *
+     * Gli hash occupano le parole che seguono il contatore _nodes_refs e
+     * sono condivisi insieme agli identificativi.
+     */
+    std::uint64_t* nodeHashes() const {
+        return reinterpret_cast<bit_word*>(_nodes_refs) + 1;
+    }
+
+    /**
+     * @brief Hash di un nodo dato da E, se E ha un metodo hash.
+     */
+    template <typename F>
+    static auto hashOf(const F& equal, const T& node, int, int) ->
+            decltype(std::uint64_t(equal.hash(node))) {
+        return equal.hash(node);
+    }
+
+    /**
+     * @brief Hash di un nodo con std::hash, se E è std::equal_to e
+     * std::hash è disponibile per U: i due sono coerenti per definizione.
+     */
+    template <typename U>
+    static auto hashOf(const std::equal_to<U>&, const U& node, int, long) ->
+            decltype(std::uint64_t(std::hash<U>()(node))) {
+        return std::hash<U>()(node);
+    }
+
+    /**
+     * @brief Versione per gli altri funtori: tutti i nodi hanno hash 0.
+     */
+    template <typename F>
+    static std::uint64_t hashOf(const F&, const T&, long, long) {
+        return 0;
+    }
+
+    /**
+     * @brief Imposta il nodo in posizione i e il suo hash.
+     */
+    void setNode(unsigned int i, const T& node) {
+        _nodes[i] = node;
+        nodeHashes()[i] = hashOf(_equal, node, 0, 0);
+    }
+
+    /**
+     * @brief Copia nella posizione i il nodo in posizione j di src, con il
+     * suo hash già calcolato.
+     */
+    void copyNode(unsigned int i, const Digraph& src, unsigned int j) {
+        _nodes[i] = src._nodes[j];
+        nodeHashes()[i] = src.nodeHashes()[j];
+    }
+
+    /**
+     * @brief Contributo a _fingerprint di un nodo con hash h.
+     */
+    static std::uint64_t nodeTerm(std::uint64_t h) {
+        return mixBits(h ^ NODE_TERM);
+    }
+
+    /**
+     * @brief Contributo a _fingerprint dell'arco tra i nodi in posizione i
+     * e j.
+     */
+    std::uint64_t edgeTerm(unsigned int i, unsigned int j) const {
+        return mixBits(nodeHashes()[i] * EDGE_MULTIPLIER + nodeHashes()[j]);
+    }
+
+    /**
+     * @brief Dimensione in byte di una matrice di adiacenza del grafo.
+     */
+    std::size_t matrixBytes() const {
+        return std::size_t(_nodes_number) * _row_words * sizeof(bit_word);
+    }
+
+    /**
+     * @brief Numero di fasce di una matrice di n righe.
+     */
+    static unsigned int bandsNumber(unsigned int n) {
+        return (n + BAND_ROWS - 1) / BAND_ROWS;
+    }
+
+    /**
+     * @brief Parole della fascia b di una matrice n x n.
+     */
+    static std::size_t bandWords(unsigned int n, unsigned int b) {
+        return std::size_t(std::min(BAND_ROWS, n - b * BAND_ROWS)) *
+               bitWords(n);
+    }
+
+    /**
+     * @brief Contatore dei riferimenti della fascia.
+     * 
+     * Il contatore occupa la parola che precede la prima riga della fascia.
+     */
+    static ref_count& bandRefs(const bit_word* band) {
+        return *reinterpret_cast<ref_count*>(const_cast<bit_word*>(band) - 1);
+    }
+
+    /**
+     * @brief Ritorna la riga i di una matrice divisa in fasce.
+     */
+    static bit_word* rowIn(bit_word* const* table, unsigned int i,
+            unsigned int words) {
+        return table[i / BAND_ROWS] + std::size_t(i % BAND_ROWS) * words;
+    }
+
+    /**
+     * @brief Alloca una fascia di words parole, non inizializzate, con il
+     * contatore a 1.
+     * 
+     * @return Puntatore alla prima riga della fascia.
+     * @throw eccezione di allocazione della memoria
+     */
+    bit_word* allocateBand(std::size_t words) {
+        matrix_alloc_type matrix_alloc(_alloc);
+        bit_word* raw = matrix_traits::allocate(matrix_alloc, words + 1);
+
+        ::new (static_cast<void*>(raw)) ref_count(1);
+        return raw + 1;
+    }
+
+    /**
+     * @brief Rilascia un riferimento alla fascia, che viene restituita
+     * all'allocatore quando non è più condivisa.
+     */
+    void releaseBand(bit_word* band, std::size_t words) {
+        if (--bandRefs(band) == 0) {
+            matrix_alloc_type matrix_alloc(_alloc);
+            matrix_traits::deallocate(matrix_alloc, band - 1, words + 1);
+        }
+    }
+
+    /**
+     * @brief Alloca una matrice di bit n x n azzerata.
+     * 
+     * La matrice è divisa in fasce di BAND_ROWS righe contigue, allocate e
+     * condivise separatamente.
+     * 
+     * @param n Numero di righe e colonne.
+     * @return Tabella delle fasce della matrice.
+     * @throw eccezione di allocazione della memoria
+     */
+    bit_word** allocateMatrix(unsigned int n) {
+        table_alloc_type table_alloc(_alloc);
+        const unsigned int bands = bandsNumber(n);
+        bit_word** table = table_traits::allocate(table_alloc, bands);
+        unsigned int b = 0;
+
+        try {
+            for (; b < bands; ++b) {
+                const std::size_t words = bandWords(n, b);
+                table[b] = allocateBand(words);
+                std::fill(table[b], table[b] + words, bit_word(0));
+            }
+        } catch(...) {
+            for (unsigned int k = 0; k < b; ++k) {
+                releaseBand(table[k], bandWords(n, k));
+            }
+            table_traits::deallocate(table_alloc, table, bands);
+            throw;
+        }
+        return table;
+    }
+
+    /**
+     * @brief Crea una nuova tabella che condivide le fasce di table.
+     * 
+     * Costo O(n/BAND_ROWS), nessuna riga viene copiata.
+     * 
+     * @param table Tabella da condividere, di una matrice n x n.
+     * @param n Numero di righe e colonne.
+     * @return Tabella con le stesse fasce di table.
+     * @throw eccezione di allocazione della memoria
+     */
+    bit_word** shareMatrix(bit_word* const* table, unsigned int n) {
+        table_alloc_type table_alloc(_alloc);
+        const unsigned int bands = bandsNumber(n);
+        bit_word** shared = table_traits::allocate(table_alloc, bands);
+
+        for (unsigned int b = 0; b < bands; ++b) {
+            shared[b] = table[b];
+            ++bandRefs(shared[b]);
+        }
+        return shared;
+    }
+
+    /**
+     * @brief Rilascia le fasce di una matrice n x n e ne dealloca la tabella.
+     * 
+     * @param table Tabella da deallocare, può essere nullptr.
+     * @param n Numero di righe e colonne.
+     */
+    void deallocateMatrix(bit_word** table, unsigned int n) {
+        if (table != nullptr) {
+            table_alloc_type table_alloc(_alloc);
+            const unsigned int bands = bandsNumber(n);
+
+            for (unsigned int b = 0; b < bands; ++b) {
+                releaseBand(table[b], bandWords(n, b));
             }
+            table_traits::deallocate(table_alloc, table, bands);
         }
     }
 
     /**
      * @brief Funzione che dealloca tutte le risorse allocate dinamicamente
      * 
-     * La funzione mantiene la consistenza dell'oggetto. 
+     * La funzione mantiene la consistenza dell'oggetto. La memoria viene
+     * restituita all'allocatore _alloc; gli identificativi e le fasce
+     * condivisi con altri Digraph vengono solo rilasciati.
      */
     void clear() {
-        delete[] _nodes;
-        _nodes = nullptr;
-
-        for (unsigned int i = 0; i < _nodes_number; ++i) {
-            delete[] _adj_matrix[i];
-            _adj_matrix[i] = nullptr;
+        if (_nodes_number != 0) {
+            if (--*_nodes_refs == 0) {
+                matrix_alloc_type matrix_alloc(_alloc);
+                for (unsigned int i = 0; i < _nodes_number; ++i) {
+                    node_traits::destroy(_alloc, _nodes + i);
+                }
+                node_traits::deallocate(_alloc, _nodes, _nodes_number);
+                matrix_traits::deallocate(matrix_alloc,
+                    reinterpret_cast<bit_word*>(_nodes_refs),
+                    _nodes_number + 1);
+            }
+            deallocateMatrix(_adj_matrix, _nodes_number);
+            deallocateMatrix(_adj_transpose, _nodes_number);
         }
-        delete[] _adj_matrix;
+        _nodes = nullptr;
+        _nodes_refs = nullptr;
         _adj_matrix = nullptr;
+        _adj_transpose = nullptr;
 
         _nodes_number = 0;
+        _row_words = 0;
         _edges_number = 0;
+        _fingerprint = 0;
     }
 
     /**
-     * @brief funzione che ritorna la posizione del nodo
+     * @brief Scambia il contenuto di *this e other, allocatori esclusi.
      * 
-     * @param u Nodo sorgende da cercare.
-     * @return Posizione di u in _nodes, _nodes_number se u non presente.
+     * Usata internamente quando i due Digraph condividono lo stesso
+     * allocatore, ad esempio con i Digraph temporanei di addNode.
+     * 
+     * @param other Digraph con cui eseguire la swap
      */
-    unsigned int nodeIndex(const T& u) const {
-        for (unsigned int i=0; i < _nodes_number; ++i) {
-            if (_equal(_nodes[i], u)) {
-                return i;
+    void swapData(Digraph& other) {
+        std::swap(_nodes, other._nodes);
+        std::swap(_nodes_refs, other._nodes_refs);
+        std::swap(_nodes_number, other._nodes_number);
+        std::swap(_row_words, other._row_words);
+        std::swap(_adj_matrix, other._adj_matrix);
+        std::swap(_adj_transpose, other._adj_transpose);
+        std::swap(_keep_transpose, other._keep_transpose);
+        std::swap(_edges_number, other._edges_number);
+        std::swap(_fingerprint, other._fingerprint);
+    }
+
+    /**
+     * @brief Sostituisce il contenuto di *this con quello del temporaneo tmp.
+     * 
+     * Le statistiche raccolte da tmp durante la sua costruzione vengono
+     * sommate a quelle di *this.
+     * 
+     * @param tmp Digraph temporaneo con lo stesso allocatore di *this.
+     */
+    void adopt(Digraph& tmp) {
+        swapData(tmp);
+        S::merge(tmp);
+    }
+
+    /**
+     * @brief Scambia gli allocatori se la propagazione è prevista.
+     */
+    static void swapAllocators(A& a, A& b, std::true_type) {
+        using std::swap;
+        swap(a, b);
+    }
+
+    /**
+     * @brief Gli allocatori non vengono propagati: non fa nulla.
+     */
+    static void swapAllocators(A&, A&, std::false_type) {}
+
+    /**
+     * @brief Condivide nodi e archi di other con *this, che deve essere
+     * vuoto.
+     * 
+     * Identificativi e fasce non vengono copiati ma solo referenziati, costo
+     * O(n/BAND_ROWS). Richiede che other usi un allocatore uguale a _alloc.
+     * 
+     * @param other Digraph da condividere
+     * @throw eccezione di allocazione della memoria
+     */
+    void shareFrom(const Digraph& other) {
+        const unsigned int n = other._nodes_number;
+        if (n == 0) {
+            _keep_transpose = other._keep_transpose;
+            return;
+        }
+
+        bit_word** matrix = shareMatrix(other._adj_matrix, n);
+        bit_word** transpose = nullptr;
+        if (other._adj_transpose != nullptr) {
+            try {
+                transpose = shareMatrix(other._adj_transpose, n);
+            } catch(...) {
+                deallocateMatrix(matrix, n);
+                throw;
             }
         }
-        return _nodes_number;
+
+        ++*other._nodes_refs;
+        _nodes = other._nodes;
+        _nodes_refs = other._nodes_refs;
+        _nodes_number = n;
+        _row_words = other._row_words;
+        _adj_matrix = matrix;
+        _adj_transpose = transpose;
+        _keep_transpose = other._keep_transpose;
+        _edges_number = other._edges_number;
+        _fingerprint = other._fingerprint;
     }
 
     /**
-     * @brief funzione che inverte lo stato dell'arco indicato.
+     * @brief Copia nodi e archi di other in *this, che deve essere vuoto.
      * 
-     * Se l'arco esiste viene eliminato.
-     * Se l'arco non esiste viene creato.
+     * Se gli allocatori sono uguali la memoria viene condivisa con
+     * shareFrom, altrimenti viene ottenuta dall'allocatore di *this e
+     * copiata. Se other mantiene la trasposta, anche la copia la mantiene.
      * 
-     * @param u Nodo sorgende dell'arco.
-     * @param v Nodo destinazione dell'arco.
+     * @param other Digraph da copiare
+     * @throw eccezione di allocazione della memoria
      */
-    void setEdge(const T& u, const T& v) {
-        assert(exists(u));
-        assert(exists(v));
+    void copyFrom(const Digraph& other) {
+        if (_alloc == other._alloc) {
+            shareFrom(other);
+            return;
+        }
+
+        Digraph tmp(other._nodes_number, _alloc, other._keep_transpose);
+        tmp.countCopied(other._nodes_number * sizeof(T) +
+                        other.matrixBytes() * (other._keep_transpose ? 2 : 1));
+
+        for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
+            tmp.copyNode(i, other, i);
+        }
 
-        unsigned int u_ind = nodeIndex(u);
-        unsigned int v_ind = nodeIndex(v);
+        for (unsigned int b = 0; b < bandsNumber(tmp._nodes_number); ++b) {
+            const std::size_t words = bandWords(tmp._nodes_number, b);
+            std::copy(other._adj_matrix[b], other._adj_matrix[b] + words,
+                      tmp._adj_matrix[b]);
+            if (tmp._adj_transpose != nullptr) {
+                std::copy(other._adj_transpose[b],
+                          other._adj_transpose[b] + words,
+                          tmp._adj_transpose[b]);
+            }
+        }
+        tmp._edges_number = other._edges_number;
+        tmp._fingerprint = other._fingerprint;
 
-        _adj_matrix[u_ind][v_ind] = !_adj_matrix[u_ind][v_ind];
+        adopt(tmp);
     }
 
-public:
+    /**
+     * @brief Ritorna la riga i della matrice di adiacenza (successori di i).
+     */
+    const bit_word* row(unsigned int i) const {
+        return rowIn(_adj_matrix, i, _row_words);
+    }
 
     /**
-     * @brief Costruttore default, genera un grafo vuoto.
+     * @brief Ritorna la riga i della trasposta (predecessori di i).
      * 
-     * Inizializza un grafo vuoto senza nodi e senza archi.
+     * @pre _adj_transpose != nullptr
+     */
+    const bit_word* transposedRow(unsigned int i) const {
+        return rowIn(_adj_transpose, i, _row_words);
+    }
+
+    /**
+     * @brief Ritorna la riga i di table pronta per essere modificata.
      * 
-     * @post _nodes == nullptr
-     * @post _nodes_number == 0
-     * @post _adj_matrix == nullptr
-     * @post _edges_number == 0
+     * Se la fascia che contiene la riga è condivisa con altri Digraph ne
+     * viene prima creata una copia privata: costo O(BAND_ROWS * n/64) alla
+     * prima modifica, O(1) in seguito.
+     * 
+     * @param table _adj_matrix o _adj_transpose.
+     * @param i Riga da modificare.
+     * @throw eccezione di allocazione della memoria
      */
-    Digraph() : _nodes(nullptr), _nodes_number(0), _adj_matrix(nullptr),
-            _edges_number(0) {}
+    bit_word* writableRow(bit_word** table, unsigned int i) {
+        const unsigned int b = i / BAND_ROWS;
+
+        if (bandRefs(table[b]) != 1) {
+            const std::size_t words = bandWords(_nodes_number, b);
+            bit_word* copy = allocateBand(words);
+
+            std::copy(table[b], table[b] + words, copy);
+            releaseBand(table[b], words);
+            table[b] = copy;
+            S::countAllocated(words * sizeof(bit_word));
+            S::countCopied(words * sizeof(bit_word));
+        }
+        return rowIn(table, i, _row_words);
+    }
+
+    /**
+     * @brief Ritorna true se esiste l'arco tra i nodi in posizione i e j.
+     */
+    bool edgeAt(unsigned int i, unsigned int j) const {
+        return testBit(row(i), j);
+    }
+
+    /**
+     * @brief Numero di successori del nodo in posizione i.
+     */
+    unsigned int outDegreeAt(unsigned int i) const {
+        return rowCount(row(i), _row_words);
+    }
+
+    /**
+     * @brief Numero di predecessori del nodo in posizione j.
+     * 
+     * Usa la trasposta se mantenuta, altrimenti legge la colonna j.
+     */
+    unsigned int inDegreeAt(unsigned int j) const {
+        if (_adj_transpose != nullptr) {
+            return rowCount(transposedRow(j), _row_words);
+        }
+
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            count += edgeAt(i, j) ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief funzione che ritorna la posizione del nodo
+     * 
+     * @param u Nodo sorgende da cercare.
+     * @return Posizione di u in _nodes, _nodes_number se u non presente.
+     */
+    unsigned int nodeIndex(const T& u) const {
+        for (unsigned int i=0; i < _nodes_number; ++i) {
+            if (_equal(_nodes[i], u)) {
+                S::countComparisons(i + 1);
+                return i;
+            }
+        }
+        S::countComparisons(_nodes_number);
+        return _nodes_number;
+    }
+
+    /**
+     * @brief funzione che inverte lo stato dell'arco indicato.
+     * 
+     * Se l'arco esiste viene eliminato.
+     * Se l'arco non esiste viene creato.
+     * La trasposta, se mantenuta, viene aggiornata di conseguenza.
+     * Le fasce modificate vengono prima rese private con writableRow,
+     * entrambe prima di cambiare un bit: se una copia fallisce il grafo
+     * resta invariato.
+     * Il numero di archi non viene aggiornato, _fingerprint sì: cambiano il
+     * contributo dell'arco, quello del grado uscente di i e, se l'arco è un
+     * cappio o ha un arco opposto, quello dei cappi o delle coppie
+     * reciproche.
+     * Costo O(n/64).
+     * 
+     * @param i Posizione del nodo sorgente dell'arco.
+     * @param j Posizione del nodo destinazione dell'arco.
+     * @throw eccezione di allocazione della memoria
+     */
+    void flipEdgeAt(unsigned int i, unsigned int j) {
+        const unsigned int out = outDegreeAt(i);
+        const bool present = edgeAt(i, j);
+        const std::uint64_t term = edgeTerm(i, j) +
+                                   ((i == j) ? LOOP_TERM :
+                                    edgeAt(j, i) ? RECIPROCAL_TERM : 0);
+
+        bit_word* const out_row = writableRow(_adj_matrix, i);
+        bit_word* const in_row = (_adj_transpose != nullptr) ?
+                                 writableRow(_adj_transpose, j) : nullptr;
+
+        flipBit(out_row, j);
+        if (in_row != nullptr) {
+            flipBit(in_row, i);
+        }
+
+        if (present) {
+            _fingerprint += mixBits(out - 1) - mixBits(out) - term;
+        }
+        else {
+            _fingerprint += mixBits(out + 1) - mixBits(out) + term;
+        }
+    }
+
+    /**
+     * @brief Ricalcola _fingerprint dalla matrice, costo O(n^2/64 + m).
+     */
+    void computeFingerprint() {
+        std::uint64_t sum = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            const bit_word* r = row(i);
+            sum += mixBits(rowCount(r, _row_words)) +
+                   nodeTerm(nodeHashes()[i]);
+            for (unsigned int w = 0; w < _row_words; ++w) {
+                for (bit_word bits = r[w]; bits != 0; bits &= bits - 1) {
+                    const unsigned int j = w * BIT_WORD_BITS +
+                                           lowestBit(bits);
+                    sum += edgeTerm(i, j);
+                    if (j == i) {
+                        sum += LOOP_TERM;
+                    }
+                    else if (j > i && edgeAt(j, i)) {
+                        sum += RECIPROCAL_TERM;
+                    }
+                }
+            }
+        }
+        _fingerprint = sum;
+    }
+
+    /**
+     * @brief Ritorna true se *this e other hanno gli stessi nodi e archi.
+     *
+     * Se le tabelle dei nodi coincidono le fasce vengono confrontate con
+     * memcmp, saltando quelle condivise; altrimenti le righe di other
+     * vengono rinumerate sulle posizioni di *this, con O(n^2) confronti
+     * tra nodi per allinearle.
+     */
+    bool equals(const Digraph& other) const {
+        if (_nodes_number != other._nodes_number ||
+                _edges_number != other._edges_number ||
+                _fingerprint != other._fingerprint) {
+            return false;
+        }
+
+        if (_nodes == other._nodes || sameNodeTable(other)) {
+            for (unsigned int b = 0; b < bandsNumber(_nodes_number); ++b) {
+                if (_adj_matrix[b] != other._adj_matrix[b] &&
+                        std::memcmp(_adj_matrix[b], other._adj_matrix[b],
+                                    bandWords(_nodes_number, b) *
+                                    sizeof(bit_word)) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<unsigned int> to_this(_nodes_number);
+        for (unsigned int j = 0; j < _nodes_number; ++j) {
+            to_this[j] = nodeIndex(other._nodes[j]);
+            if (to_this[j] == _nodes_number) {
+                return false;
+            }
+        }
+        std::vector<bit_word> remapped(_row_words);
+        for (unsigned int j = 0; j < _nodes_number; ++j) {
+            std::fill(remapped.begin(), remapped.end(), bit_word(0));
+            remapRow(other, j, to_this, &remapped[0]);
+            if (!std::equal(remapped.begin(), remapped.end(),
+                            row(to_this[j]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copia la matrice src di n nodi in dst di n + 1 nodi.
+     * 
+     * La riga e la colonna aggiunte in posizione k restano vuote, quelle
+     * successive vengono spostate avanti di una posizione.
+     */
+    static void copyInserting(bit_word* const* src, bit_word* const* dst,
+            unsigned int n, unsigned int k) {
+        const unsigned int src_words = bitWords(n);
+        const unsigned int dst_words = bitWords(n + 1);
+
+        for (unsigned int i = 0; i < n; ++i) {
+            copyInsertingBit(rowIn(src, i, src_words),
+                             rowIn(dst, (i < k) ? i : i + 1, dst_words),
+                             n, k);
+        }
+    }
+
+    /**
+     * @brief Copia la matrice src di n nodi in dst privandola del nodo k.
+     * 
+     * Vengono rimosse sia la riga sia la colonna k.
+     */
+    static void copyShrinking(bit_word* const* src, bit_word* const* dst,
+            unsigned int n, unsigned int k) {
+        const unsigned int src_words = bitWords(n);
+        const unsigned int dst_words = bitWords(n - 1);
+
+        for (unsigned int i = 0, d = 0; i < n; ++i) {
+            if (i != k) {
+                copyRemovingBit(rowIn(src, i, src_words),
+                                rowIn(dst, d, dst_words), n, k);
+                ++d;
+            }
+        }
+    }
+
+    /**
+     * @brief Ritorna true se other ha gli stessi nodi nello stesso ordine.
+     */
+    bool sameNodeTable(const Digraph& other) const {
+        if (_nodes_number != other._nodes_number) {
+            return false;
+        }
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            if (!_equal(_nodes[i], other._nodes[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copia in dst la riga i di src con le colonne rinumerate.
+     * 
+     * La colonna c della riga diventa la colonna to_dst[c] di dst, le
+     * colonne con to_dst[c] == NONE vengono scartate. Costo O(n/64 + grado).
+     * 
+     * @param src Grafo sorgente.
+     * @param i Riga di src da copiare.
+     * @param to_dst Rinumerazione delle colonne di src.
+     * @param dst Riga destinazione, già azzerata.
+     */
+    static void remapRow(const Digraph& src, unsigned int i,
+            const std::vector<unsigned int>& to_dst, bit_word* dst) {
+        const bit_word* row = src.row(i);
+        for (unsigned int w = 0; w < src._row_words; ++w) {
+            for (bit_word bits = row[w]; bits != 0; bits &= bits - 1) {
+                const unsigned int c = to_dst[w * BIT_WORD_BITS +
+                                              lowestBit(bits)];
+                if (c != NONE) {
+                    flipBit(dst, c);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Combina parola per parola le matrici di a e b.
+     * 
+     * Se i due grafi hanno gli stessi nodi nello stesso ordine le righe
+     * vengono combinate direttamente con op, costo O(n^2/64). Altrimenti le
+     * tabelle dei nodi vengono allineate una sola volta con O(n_a * n_b)
+     * confronti, dopodichè ogni riga viene rinumerata sui nodi del
+     * risultato e combinata con op. Il numero di archi viene calcolato con
+     * popcount sulle righe del risultato.
+     * 
+     * @param a Primo operando.
+     * @param b Secondo operando.
+     * @param op Operazione su bit_word.
+     * @param nodes Nodi del risultato.
+     * @return Grafo risultante, con l'allocatore di a.
+     * @throw eccezione di allocazione della memoria
+     */
+    template <typename Op>
+    static Digraph combine(const Digraph& a, const Digraph& b, Op op,
+            NodeSet nodes) {
+        if (a.sameNodeTable(b)) {
+            Digraph tmp(a._nodes_number, a._alloc);
+
+            for (unsigned int i = 0; i < a._nodes_number; ++i) {
+                tmp.copyNode(i, a, i);
+            }
+            for (unsigned int k = 0; k < bandsNumber(a._nodes_number); ++k) {
+                const std::size_t words = bandWords(a._nodes_number, k);
+                const bit_word* row_a = a._adj_matrix[k];
+                const bit_word* row_b = b._adj_matrix[k];
+                bit_word* dst = tmp._adj_matrix[k];
+
+                for (std::size_t w = 0; w < words; ++w) {
+                    dst[w] = op(row_a[w], row_b[w]);
+                    tmp._edges_number += bitCount(dst[w]);
+                }
+            }
+            tmp.computeFingerprint();
+            return tmp;
+        }
+
+        // Allineamento delle tabelle dei nodi
+        std::vector<unsigned int> b_in_a(b._nodes_number);
+        std::vector<unsigned int> a_to_r(a._nodes_number, NONE);
+        std::vector<unsigned int> b_to_r(b._nodes_number, NONE);
+        std::vector<unsigned int> r_from_a, r_from_b;
+
+        for (unsigned int j = 0; j < b._nodes_number; ++j) {
+            unsigned int i = a.nodeIndex(b._nodes[j]);
+            b_in_a[j] = (i == a._nodes_number) ? NONE : i;
+        }
+        std::vector<unsigned int> a_in_b(a._nodes_number, NONE);
+        for (unsigned int j = 0; j < b._nodes_number; ++j) {
+            if (b_in_a[j] != NONE) {
+                a_in_b[b_in_a[j]] = j;
+            }
+        }
+
+        for (unsigned int i = 0; i < a._nodes_number; ++i) {
+            if (nodes != NODES_COMMON || a_in_b[i] != NONE) {
+                a_to_r[i] = static_cast<unsigned int>(r_from_a.size());
+                if (a_in_b[i] != NONE) {
+                    b_to_r[a_in_b[i]] = a_to_r[i];
+                }
+                r_from_a.push_back(i);
+                r_from_b.push_back(a_in_b[i]);
+            }
+        }
+        if (nodes == NODES_UNION) {
+            for (unsigned int j = 0; j < b._nodes_number; ++j) {
+                if (b_in_a[j] == NONE) {
+                    b_to_r[j] = static_cast<unsigned int>(r_from_a.size());
+                    r_from_a.push_back(NONE);
+                    r_from_b.push_back(j);
+                }
+            }
+        }
+
+        const unsigned int n = static_cast<unsigned int>(r_from_a.size());
+        Digraph tmp(n, a._alloc);
+        std::vector<bit_word> row_a(tmp._row_words), row_b(tmp._row_words);
+
+        for (unsigned int k = 0; k < n; ++k) {
+            if (r_from_a[k] != NONE) {
+                tmp.copyNode(k, a, r_from_a[k]);
+            }
+            else {
+                tmp.copyNode(k, b, r_from_b[k]);
+            }
+
+            std::fill(row_a.begin(), row_a.end(), bit_word(0));
+            std::fill(row_b.begin(), row_b.end(), bit_word(0));
+            if (r_from_a[k] != NONE) {
+                remapRow(a, r_from_a[k], a_to_r, &row_a[0]);
+            }
+            if (r_from_b[k] != NONE) {
+                remapRow(b, r_from_b[k], b_to_r, &row_b[0]);
+            }
+
+            bit_word* dst = tmp.writableRow(tmp._adj_matrix, k);
+            for (unsigned int w = 0; w < tmp._row_words; ++w) {
+                dst[w] = op(row_a[w], row_b[w]);
+                tmp._edges_number += bitCount(dst[w]);
+            }
+        }
+        tmp.computeFingerprint();
+
+        return tmp;
+    }
+
+    /**
+     * @brief Sottografo indotto dai nodi selezionati in mask.
+     * 
+     * Il risultato viene allocato una sola volta e ogni riga selezionata
+     * viene compattata con gatherBits, che usa PEXT se disponibile.
+     * Costo O(k * n/64) con k nodi selezionati.
+     * 
+     * @param mask Bit a 1 in corrispondenza dei nodi da mantenere.
+     * @return Sottografo indotto, con i nodi nell'ordine di *this.
+     * @throw eccezione di allocazione della memoria
+     */
+    Digraph inducedByMask(const std::vector<bit_word>& mask) const {
+        const unsigned int k = mask.empty() ? 0 :
+                               rowCount(&mask[0], _row_words);
+        Digraph tmp(k, _alloc);
+
+        for (unsigned int w = 0, d = 0; w < _row_words; ++w) {
+            for (bit_word bits = mask[w]; bits != 0; bits &= bits - 1, ++d) {
+                const unsigned int i = w * BIT_WORD_BITS + lowestBit(bits);
+                bit_word* dst = tmp.writableRow(tmp._adj_matrix, d);
+
+                tmp.copyNode(d, *this, i);
+                gatherBits(row(i), &mask[0], _row_words, dst);
+                tmp._edges_number += rowCount(dst, tmp._row_words);
+            }
+        }
+        tmp.computeFingerprint();
+
+        return tmp;
+    }
+
+    /**
+     * @brief Inserisce node in posizione k, privo di archi.
+     * 
+     * I nodi successivi vengono spostati avanti di una posizione.
+     * 
+     * @param k Posizione del nuovo nodo, k <= _nodes_number.
+     * @param node Nodo da inserire.
+     * @throw eccezione di allocazione della memoria
+     */
+    void insertAt(unsigned int k, const T& node) {
+        Digraph tmp(_nodes_number + 1, _alloc, _keep_transpose);
+
+        for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
+            if (i == k) {
+                tmp.setNode(i, node);
+            }
+            else {
+                tmp.copyNode(i, *this, (i < k) ? i : i - 1);
+            }
+        }
+
+        copyInserting(_adj_matrix, tmp._adj_matrix, _nodes_number, k);
+        if (_adj_transpose != nullptr) {
+            copyInserting(_adj_transpose, tmp._adj_transpose, _nodes_number,
+                          k);
+        }
+        tmp._edges_number = _edges_number;
+        tmp._fingerprint = _fingerprint + mixBits(0) +
+                           nodeTerm(tmp.nodeHashes()[k]);
+
+        S::countRebuild();
+        S::countCopied(_nodes_number * sizeof(T) +
+                       matrixBytes() * (_keep_transpose ? 2 : 1));
+        adopt(tmp);
+    }
+
+    /**
+     * @brief Rimuove il nodo in posizione k e tutti i suoi archi.
+     * 
+     * @param k Posizione del nodo, k < _nodes_number.
+     * @throw eccezione di allocazione della memoria
+     */
+    void removeAt(unsigned int k) {
+        Digraph tmp(_nodes_number - 1, _alloc, _keep_transpose);
+
+        for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
+            tmp.copyNode(i, *this, (i < k) ? i : i + 1);
+        }
+
+        if (tmp._nodes_number != 0) {
+            copyShrinking(_adj_matrix, tmp._adj_matrix, _nodes_number, k);
+            if (_adj_transpose != nullptr) {
+                copyShrinking(_adj_transpose, tmp._adj_transpose,
+                              _nodes_number, k);
+            }
+        }
+        tmp._edges_number = _edges_number - outDegreeAt(k) -
+                            inDegreeAt(k) + (edgeAt(k, k) ? 1 : 0);
+        tmp.computeFingerprint();
+
+        S::countRebuild();
+        S::countCopied(tmp._nodes_number * sizeof(T) +
+                       tmp.matrixBytes() * (_keep_transpose ? 2 : 1));
+        adopt(tmp);
+    }
+
+    /**
+     * @brief Elimina dal journal le voci dalla posizione p in poi.
+     */
+    void truncateJournal(std::size_t p) {
+        if (p < _journal->entries.size()) {
+            const JournalEntry& first = _journal->entries[p];
+            _journal->nodes.erase(_journal->nodes.begin() + first.node,
+                                  _journal->nodes.end());
+            _journal->links.erase(_journal->links.begin() + first.links,
+                                  _journal->links.end());
+            _journal->entries.erase(_journal->entries.begin() + p,
+                                    _journal->entries.end());
+        }
+        _journal->position = p;
+    }
+
+    /**
+     * @brief Registra una modifica nel journal, se attivo.
+     * 
+     * Le modifiche annullate e non riapplicate vengono scartate. Per
+     * NODE_REMOVED vengono salvati anche i successori (compreso il nodo
+     * stesso se ha un cappio) e i predecessori del nodo, come posizioni.
+     * Va chiamata prima di applicare la modifica; se l'applicazione fallisce
+     * la voce va rimossa con discardLast.
+     * 
+     * @param op Tipo di modifica.
+     * @param u Sorgente dell'arco o posizione del nodo.
+     * @param v Destinazione dell'arco.
+     * @param node Nodo aggiunto o rimosso, nullptr per gli archi.
+     * @throw eccezione di allocazione della memoria
+     */
+    void record(JournalOp op, unsigned int u, unsigned int v,
+            const T* node) {
+        if (_journal == nullptr) {
+            return;
+        }
+        truncateJournal(_journal->position);
+
+        JournalEntry entry;
+        entry.op = op;
+        entry.u = u;
+        entry.v = v;
+        entry.out = 0;
+        entry.in = 0;
+        entry.node = _journal->nodes.size();
+        entry.links = _journal->links.size();
+
+        try {
+            if (node != nullptr) {
+                _journal->nodes.push_back(*node);
+            }
+            if (op == NODE_REMOVED) {
+                const bit_word* out = row(u);
+                for (unsigned int w = 0; w < _row_words; ++w) {
+                    for (bit_word bits = out[w]; bits != 0; bits &= bits - 1) {
+                        _journal->links.push_back(w * BIT_WORD_BITS +
+                                                  lowestBit(bits));
+                        ++entry.out;
+                    }
+                }
+                std::vector<bit_word> column(_row_words, bit_word(0));
+                if (_adj_transpose != nullptr) {
+                    column.assign(transposedRow(u), transposedRow(u) +
+                                                    _row_words);
+                }
+                else {
+                    for (unsigned int i = 0; i < _nodes_number; ++i) {
+                        if (edgeAt(i, u)) {
+                            flipBit(&column[0], i);
+                        }
+                    }
+                }
+                for (unsigned int w = 0; w < _row_words; ++w) {
+                    for (bit_word bits = column[w]; bits != 0;
+                            bits &= bits - 1) {
+                        const unsigned int i = w * BIT_WORD_BITS +
+                                               lowestBit(bits);
+                        if (i != u) {
+                            _journal->links.push_back(i);
+                            ++entry.in;
+                        }
+                    }
+                }
+            }
+            _journal->entries.push_back(entry);
+        } catch(...) {
+            _journal->nodes.resize(entry.node);
+            _journal->links.resize(entry.links);
+            throw;
+        }
+        ++_journal->position;
+    }
+
+    /**
+     * @brief Rimuove l'ultima voce registrata, la cui modifica è fallita.
+     */
+    void discardLast() {
+        if (_journal != nullptr) {
+            truncateJournal(_journal->position - 1);
+        }
+    }
+
+    /**
+     * @brief Annulla la modifica entry, l'ultima applicata.
+     * 
+     * Se viene lanciata un'eccezione il grafo resta invariato: un arco
+     * viene invertito da flipEdgeAt solo dopo aver reso private le fasce,
+     * e il numero di archi aggiornato dopo; un nodo rimosso viene
+     * reinserito con i suoi archi in un Digraph temporaneo, adottato solo
+     * alla fine, e un nodo aggiunto viene tolto ricostruendo il grafo.
+     * 
+     * @throw eccezione di allocazione della memoria
+     */
+    void undoEntry(const JournalEntry& entry) {
+        switch (entry.op) {
+        case EDGE_ADDED:
+            flipEdgeAt(entry.u, entry.v);
+            --_edges_number;
+            break;
+        case EDGE_REMOVED:
+            flipEdgeAt(entry.u, entry.v);
+            ++_edges_number;
+            break;
+        case NODE_ADDED:
+            removeAt(entry.u);
+            break;
+        case NODE_REMOVED: {
+            Digraph tmp(_alloc);
+            tmp.shareFrom(*this);
+            tmp.insertAt(entry.u, _journal->nodes[entry.node]);
+            for (unsigned int l = 0; l < entry.out + entry.in; ++l) {
+                const unsigned int other = _journal->links[entry.links + l];
+                if (l < entry.out) {
+                    tmp.flipEdgeAt(entry.u, other);
+                }
+                else {
+                    tmp.flipEdgeAt(other, entry.u);
+                }
+            }
+            tmp._edges_number += entry.out + entry.in;
+            adopt(tmp);
+            break;
+        }
+        }
+    }
+
+    /**
+     * @brief Riapplica la modifica entry, la prima annullata.
+     * 
+     * Come undoEntry, se viene lanciata un'eccezione il grafo resta
+     * invariato.
+     * 
+     * @throw eccezione di allocazione della memoria
+     */
+    void redoEntry(const JournalEntry& entry) {
+        switch (entry.op) {
+        case EDGE_ADDED:
+            flipEdgeAt(entry.u, entry.v);
+            ++_edges_number;
+            break;
+        case EDGE_REMOVED:
+            flipEdgeAt(entry.u, entry.v);
+            --_edges_number;
+            break;
+        case NODE_ADDED:
+            insertAt(entry.u, _journal->nodes[entry.node]);
+            break;
+        case NODE_REMOVED:
+            removeAt(entry.u);
+            break;
+        }
+    }
+
+    /**
+     * @brief Distrugge il journal e lo restituisce al suo allocatore.
+     */
+    void freeJournal() {
+        if (_journal != nullptr) {
+            journal_alloc_type journal_alloc(_journal->alloc);
+            journal_traits::destroy(journal_alloc, _journal);
+            journal_traits::deallocate(journal_alloc, _journal, 1);
+            _journal = nullptr;
+        }
+    }
+
+    /**
+     * @brief Inoltra a un allocatore con willNeed il consiglio di leggere
+     * a breve [p, p + bytes).
+     */
+    template <typename X>
+    static auto adviseWillNeed(const X& alloc, const void* p,
+            std::size_t bytes, int) -> decltype(alloc.willNeed(p, bytes)) {
+        return alloc.willNeed(p, bytes);
+    }
+
+    /**
+     * @brief Versione per gli allocatori senza willNeed, non fa nulla.
+     */
+    template <typename X>
+    static void adviseWillNeed(const X&, const void*, std::size_t, long) {}
+
+    /**
+     * @brief Inoltra a un allocatore con sequential la modalità di accesso
+     * di [p, p + bytes).
+     */
+    template <typename X>
+    static auto adviseSequential(const X& alloc, const void* p,
+            std::size_t bytes, bool on, int) ->
+            decltype(alloc.sequential(p, bytes, on)) {
+        return alloc.sequential(p, bytes, on);
+    }
+
+    /**
+     * @brief Versione per gli allocatori senza sequential, non fa nulla.
+     */
+    template <typename X>
+    static void adviseSequential(const X&, const void*, std::size_t, bool,
+            long) {}
+
+    /**
+     * @brief Thread che eseguono più volte un compito su intervalli
+     * disgiunti di righe che coprono tutte le righe della matrice.
+     *
+     * Gli intervalli sono formati da fasce intere, così thread diversi
+     * leggono e scrivono righe diverse. I thread vengono creati una sola
+     * volta e tra un compito e l'altro attendono su una condition variable:
+     * gli algoritmi iterativi come pageRank pagano la creazione dei thread
+     * una volta sola e non a ogni prodotto. Il thread chiamante elabora
+     * l'ultimo intervallo.
+     */
+    class RowWorkers {
+        std::mutex _mutex; ///< Protegge i campi del compito
+        std::condition_variable _start; ///< Nuovo compito o fine
+        std::condition_variable _done; ///< Compito finito da tutti
+        void (*_call)(const void*, unsigned int, unsigned int); ///< Compito
+        const void* _job; ///< Funtore del compito
+        unsigned long _generation; ///< Compiti avviati
+        std::size_t _running; ///< Thread che non hanno finito il compito
+        bool _stop; ///< Richiesta di terminazione
+        unsigned int _first; ///< Prima riga dell'intervallo del chiamante
+        unsigned int _rows; ///< Righe della matrice
+        std::vector<std::thread> _threads; ///< Thread di lavoro
+
+        RowWorkers(const RowWorkers&); // Non copiabile
+        RowWorkers& operator=(const RowWorkers&); // Non assegnabile
+
+        /**
+         * @brief Chiama il funtore di tipo F puntato da f.
+         */
+        template <typename F>
+        static void invoke(const void* f, unsigned int first,
+                unsigned int last) {
+            (*static_cast<const F*>(f))(first, last);
+        }
+
+        /**
+         * @brief Ciclo di un thread: esegue ogni compito su [first, last).
+         */
+        void work(unsigned int first, unsigned int last) {
+            unsigned long seen = 0;
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (;;) {
+                while (!_stop && _generation == seen) {
+                    _start.wait(lock);
+                }
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+                void (*call)(const void*, unsigned int, unsigned int) = _call;
+                const void* job = _job;
+
+                lock.unlock();
+                call(job, first, last);
+                lock.lock();
+                if (--_running == 0) {
+                    _done.notify_one();
+                }
+            }
+        }
+
+        /**
+         * @brief Ferma e attende i thread.
+         */
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _start.notify_all();
+            for (std::size_t t = 0; t < _threads.size(); ++t) {
+                _threads[t].join();
+            }
+        }
+
+    public:
+        /**
+         * @brief Costruttore, divide rows righe e avvia i thread.
+         *
+         * @param rows Righe della matrice.
+         * @param threads Numero massimo di thread compreso il chiamante,
+         *  0 per usarne uno per core.
+         * @throw std::system_error se un thread non può essere creato
+         */
+        RowWorkers(unsigned int rows, unsigned int threads) : _call(nullptr),
+                _job(nullptr), _generation(0), _running(0), _stop(false),
+                _first(0), _rows(rows) {
+            const unsigned int bands = bandsNumber(rows);
+            if (threads == 0) {
+                threads = std::thread::hardware_concurrency();
+            }
+            threads = std::max(1u, std::min(threads, bands));
+            if (bands == 0) {
+                return;
+            }
+
+            const unsigned int per_thread = (bands + threads - 1) / threads;
+            try {
+                for (; _first + per_thread < bands; _first += per_thread) {
+                    _threads.push_back(std::thread(&RowWorkers::work, this,
+                        _first * BAND_ROWS,
+                        (_first + per_thread) * BAND_ROWS));
+                }
+            } catch(...) {
+                stop();
+                throw;
+            }
+            _first *= BAND_ROWS;
+        }
+
+        /**
+         * @brief Distruttore, ferma i thread.
+         */
+        ~RowWorkers() {
+            stop();
+        }
+
+        /**
+         * @brief Esegue f(first, last) sugli intervalli di tutti i thread e
+         * ritorna quando sono finiti.
+         *
+         * f non deve lanciare eccezioni.
+         */
+        template <typename F>
+        void run(const F& f) {
+            if (_rows == 0) {
+                return;
+            }
+            if (!_threads.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _call = &invoke<F>;
+                    _job = &f;
+                    _running = _threads.size();
+                    ++_generation;
+                }
+                _start.notify_all();
+            }
+            f(_first, _rows);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (_running != 0) {
+                _done.wait(lock);
+            }
+        }
+    };
+
+    /**
+     * @brief Esegue una volta f(first, last) su intervalli disgiunti di
+     * righe che coprono tutte le righe della matrice, in parallelo.
+     *
+     * Crea i thread per questa sola chiamata: chi ripete più compiti usa
+     * un RowWorkers per tutti. f non deve lanciare eccezioni.
+     *
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @throw std::system_error se un thread non può essere creato
+     */
+    template <typename F>
+    void parallelRows(F f, unsigned int threads) const {
+        RowWorkers workers(_nodes_number, threads);
+        workers.run(f);
+    }
+
+    /**
+     * @brief Conta i triangoli e gli archi reciproci di ogni nodo.
+     *
+     * Per il nodo u e ogni successore v != u, i nodi w tali che
+     * v -> w -> u sono l'AND tra la riga di v e la riga di u della
+     * trasposta: ogni triangolo che contiene u viene contato una volta,
+     * sul suo unico arco uscente da u. Costo O(m * n / 64).
+     * Senza trasposta mantenuta ne viene calcolata una temporanea.
+     *
+     * @param triangles Array di nodesNumber() contatori, oppure nullptr.
+     * @param reciprocal Array di nodesNumber() contatori, oppure nullptr.
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    void countCycles(unsigned long long* triangles, unsigned int* reciprocal,
+            unsigned int threads) const {
+        if (_nodes_number == 0) {
+            return;
+        }
+        if (_adj_transpose == nullptr) {
+            Digraph tmp(*this);
+            tmp.keepTranspose(true);
+            tmp.countCycles(triangles, reciprocal, threads);
+            return;
+        }
+
+        const Digraph& g = *this;
+        parallelRows([&g, triangles, reciprocal](unsigned int first,
+                unsigned int last) {
+            const unsigned int words = g._row_words;
+            for (unsigned int u = first; u < last; ++u) {
+                const bit_word* out = g.row(u);
+                const bit_word* in = g.transposedRow(u);
+                const bool loop = testBit(out, u);
+
+                if (reciprocal != nullptr) {
+                    unsigned int count = 0;
+                    for (unsigned int w = 0; w < words; ++w) {
+                        count += bitCount(out[w] & in[w]);
+                    }
+                    reciprocal[u] = count - (loop ? 1 : 0);
+                }
+
+                if (triangles == nullptr) {
+                    continue;
+                }
+                unsigned long long count = 0;
+                for (unsigned int k = 0; k < words; ++k) {
+                    for (bit_word bits = out[k]; bits != 0;
+                            bits &= bits - 1) {
+                        const unsigned int v = k * BIT_WORD_BITS +
+                                               lowestBit(bits);
+                        if (v == u) {
+                            continue;
+                        }
+                        const bit_word* next = g.row(v);
+                        for (unsigned int w = 0; w < words; ++w) {
+                            count += bitCount(next[w] & in[w]);
+                        }
+                        // w deve essere diverso da u e da v
+                        count -= (loop && testBit(next, u)) ? 1 : 0;
+                        count -= (testBit(next, v) && testBit(in, v)) ?
+                                 1 : 0;
+                    }
+                }
+                triangles[u] = count;
+            }
+        }, threads);
+    }
+
+    /**
+     * @brief Righe di una matrice in formato compresso, vedi compressRows.
+     */
+    typedef std::vector<unsigned int, index_alloc_type> index_vector;
+
+    /**
+     * @brief Converte le righe di table in formato compresso.
+     *
+     * Le colonne a 1 della riga i diventano indices[offsets[i]] ...
+     * indices[offsets[i + 1] - 1]. Costo O(n^2 / 64 + m), ripagato dalle
+     * iterazioni successive che costano O(n + m) invece di O(n^2 / 64 + m).
+     */
+    void compressRows(bit_word* const* table, index_vector& offsets,
+            index_vector& indices) const {
+        offsets.assign(_nodes_number + 1, 0);
+        indices.clear();
+        indices.reserve(_edges_number);
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            const bit_word* r = rowIn(table, i, _row_words);
+            for (unsigned int w = 0; w < _row_words; ++w) {
+                for (bit_word bits = r[w]; bits != 0; bits &= bits - 1) {
+                    indices.push_back(w * BIT_WORD_BITS + lowestBit(bits));
+                }
+            }
+            offsets[i + 1] = static_cast<unsigned int>(indices.size());
+        }
+    }
+
+    /**
+     * @brief True se le righe contengono in media meno di un arco per
+     * parola, quindi conviene iterare sul formato compresso.
+     */
+    bool sparseRows() const {
+        return _edges_number < std::size_t(_nodes_number) * _row_words;
+    }
+
+    /**
+     * @brief Prodotto tra le righe di table e x: y[i] è la somma di x[j]
+     * sulle colonne j a 1 della riga i.
+     *
+     * Con offsets non vuoto legge le righe compresse da compressRows,
+     * altrimenti le righe di bit: le parole con almeno MASKED_SUM_MIN_BITS
+     * bit a 1 sono sommate con maskedSum, le altre scorrendo i bit.
+     * Le righe sono divise tra i thread di workers.
+     *
+     * @param x Vettore di bitWords(n) * 64 valori, quelli oltre n a zero.
+     * @param y Vettore di n valori.
+     * @param workers Thread creati per le righe di *this.
+     */
+    template <typename V>
+    void multiplyRows(bit_word* const* table, const index_vector& offsets,
+            const index_vector& indices, const V* x, V* y,
+            RowWorkers& workers) const {
+        const unsigned int words = _row_words;
+        const bool compressed = !offsets.empty();
+
+        workers.run([table, words, compressed, &offsets, &indices, x, y](
+                unsigned int first, unsigned int last) {
+            for (unsigned int i = first; i < last; ++i) {
+                V sum = V(0);
+                if (compressed) {
+                    for (unsigned int k = offsets[i]; k < offsets[i + 1];
+                            ++k) {
+                        sum += x[indices[k]];
+                    }
+                    y[i] = sum;
+                    continue;
+                }
+
+                const bit_word* r = rowIn(table, i, words);
+                for (unsigned int w = 0; w < words; ++w) {
+                    const V* block = x + std::size_t(w) * BIT_WORD_BITS;
+                    if (bitCount(r[w]) >= MASKED_SUM_MIN_BITS) {
+                        sum += maskedSum(block, r[w]);
+                        continue;
+                    }
+                    for (bit_word bits = r[w]; bits != 0; bits &= bits - 1) {
+                        sum += block[lowestBit(bits)];
+                    }
+                }
+                y[i] = sum;
+            }
+        });
+    }
+
+    /**
+     * @brief Divide v per la sua norma euclidea, se non nulla.
+     */
+    template <typename V>
+    static void normalize(std::vector<V>& v) {
+        V norm = V(0);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            norm += v[i] * v[i];
+        }
+        norm = std::sqrt(norm);
+        if (norm > V(0)) {
+            for (std::size_t i = 0; i < v.size(); ++i) {
+                v[i] /= norm;
+            }
+        }
+    }
+
+public:
+    typedef A allocator_type; ///< Tipo dell'allocatore
+
+    /**
+     * @brief Costruttore default, genera un grafo vuoto.
+     * 
+     * Inizializza un grafo vuoto senza nodi e senza archi.
+     * 
+     * @post _nodes == nullptr
+     * @post _nodes_number == 0
+     * @post _adj_matrix == nullptr
+     * @post _edges_number == 0
+     */
+    Digraph() : _nodes(nullptr), _nodes_refs(nullptr), _nodes_number(0),
+            _row_words(0), _adj_matrix(nullptr), _adj_transpose(nullptr),
+            _keep_transpose(false), _edges_number(0), _fingerprint(0),
+            _alloc(), _journal(nullptr) {}
+
+    /**
+     * @brief Costruttore che genera un grafo vuoto con l'allocatore dato.
+     * 
+     * @param alloc Allocatore usato per tutte le allocazioni del grafo.
+     */
+    explicit Digraph(const A& alloc) : _nodes(nullptr), _nodes_refs(nullptr),
+            _nodes_number(0), _row_words(0), _adj_matrix(nullptr),
+            _adj_transpose(nullptr), _keep_transpose(false), _edges_number(0),
+            _fingerprint(0), _alloc(alloc), _journal(nullptr) {}
+
+    /**
+     * @brief Costruttore che genera un grafo con i nodi indicati e privo di
+     * archi.
+     * 
+     * Equivale a chiamare addNode per ogni nodo, ma alloca il grafo una sola
+     * volta.
+     * 
+     * @param first Iteratore al primo nodo.
+     * @param last Iteratore alla fine della sequenza di nodi.
+     * @param alloc Allocatore usato per tutte le allocazioni del grafo.
+     * @pre i nodi della sequenza sono distinti
+     * @throw eccezione di allocazione della memoria
+     */
+    template <typename FwdIt>
+    Digraph(FwdIt first, FwdIt last, const A& alloc = A()) :
+            _nodes(nullptr), _nodes_refs(nullptr), _nodes_number(0),
+            _row_words(0), _adj_matrix(nullptr), _adj_transpose(nullptr),
+            _keep_transpose(false), _edges_number(0), _fingerprint(0),
+            _alloc(alloc), _journal(nullptr) {
+        Digraph tmp(static_cast<unsigned int>(std::distance(first, last)),
+                    _alloc);
+
+        for (unsigned int i = 0; first != last; ++first, ++i) {
+            assert(tmp.nodeIndex(*first) >= i);
+            tmp.setNode(i, *first);
+            tmp._fingerprint += nodeTerm(tmp.nodeHashes()[i]);
+        }
+
+        adopt(tmp);
+    }
+
+    /**
+     * @brief Costruttore di copia.
+     * 
+     * L'allocatore viene ottenuto da other tramite
+     * select_on_container_copy_construction, come per i container standard.
+     * Se è uguale a quello di other la copia condivide la memoria di other
+     * in O(n/64) e le fasce della matrice vengono duplicate solo quando
+     * modificate.
+     * 
+     * @param other Digraph da copiare
+     * @throw eccezione di allocazione della memoria
+     */
+    Digraph(const Digraph& other) : _nodes(nullptr), _nodes_refs(nullptr),
+            _nodes_number(0), _row_words(0), _adj_matrix(nullptr),
+            _adj_transpose(nullptr), _keep_transpose(false), _edges_number(0),
+            _fingerprint(0),
+            _alloc(node_traits::select_on_container_copy_construction(
+                other._alloc)), _journal(nullptr) {
+        copyFrom(other);
+    }
+
+    /**
+     * @brief Costruttore di copia con allocatore esplicito.
+     * 
+     * @param other Digraph da copiare
+     * @param alloc Allocatore del nuovo Digraph
+     * @throw eccezione di allocazione della memoria
+     */
+    Digraph(const Digraph& other, const A& alloc) : _nodes(nullptr),
+            _nodes_refs(nullptr), _nodes_number(0), _row_words(0),
+            _adj_matrix(nullptr), _adj_transpose(nullptr),
+            _keep_transpose(false), _edges_number(0), _fingerprint(0),
+            _alloc(alloc), _journal(nullptr) {
+        copyFrom(other);
+    }
+
+    /**
+     * @brief Distruttore.
+     * 
+     * Dealloca tutte le risorse allocate dinamicamente.
+     * 
+     * @post _nodes == nullptr
+     * @post _nodes_number == 0
+     * @post _adjacent_matrix == nullptr
+     * @post _edges_number == 0
+     */
+    ~Digraph() {
+        clear();
+        freeJournal();
+    }
+
+    /**
+     * @brief Operatore di assegnamento.
+     * 
+     * L'allocatore di other viene propagato solo se
+     * propagate_on_container_copy_assignment lo prevede. Il journal di other
+     * non viene copiato, quello di *this viene svuotato.
+     * 
+     * @param other Digraph da assegnare.
+     * @return reference al Digraph this.
+     * @throw Eccezione di allocazione della memoria.
+     */
+    Digraph& operator= (const Digraph& other) {
+        typedef typename
+            node_traits::propagate_on_container_copy_assignment propagate;
+
+        if (this != &other) {
+            Digraph tmp(other, propagate::value ? other._alloc : _alloc);
+            adopt(tmp);
+            swapAllocators(_alloc, tmp._alloc, propagate());
+            if (_journal != nullptr) {
+                truncateJournal(0);
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Swap tra *this e il Digraph other.
+     * 
+     * Se l'allocatore non prevede propagate_on_container_swap i due Digraph
+     * devono avere allocatori uguali. Anche i journal vengono scambiati.
+     * 
+     * @param other Digraph con cui eseguire la swap
+     */
+    void swap(Digraph& other) {
+        typedef typename node_traits::propagate_on_container_swap propagate;
+
+        assert(propagate::value || _alloc == other._alloc);
+
+        swapData(other);
+        std::swap(_journal, other._journal);
+        swapAllocators(_alloc, other._alloc, propagate());
+    }
+
+    /**
+     * @brief Ritorna le statistiche raccolte da questa istanza.
+     * 
+     * Con la policy NoDigraphStats i contatori sono sempre a zero.
+     * 
+     * @return Copia dei contatori dell'istanza.
+     */
+    DigraphCounters stats() const {
+        return S::snapshot();
+    }
+
+    /**
+     * @brief Azzera le statistiche di questa istanza.
+     */
+    void resetStats() {
+        S::reset();
+    }
+
+    /**
+     * @brief Ritorna le statistiche globali di tutti i Digraph con la stessa
+     * policy S.
+     * 
+     * @return Copia dei contatori globali.
+     */
+    static DigraphCounters globalStats() {
+        return S::globalSnapshot();
+    }
+
+    /**
+     * @brief Azzera le statistiche globali.
+     */
+    static void resetGlobalStats() {
+        S::globalReset();
+    }
+
+    /**
+     * @brief Ritorna l'allocatore del grafo.
+     * 
+     * @return Copia dell'allocatore.
+     */
+    allocator_type get_allocator() const {
+        return _alloc;
+    }
+
+    /**
+     * @brief Ritorna il numero di nodi nel grafo.
+     * 
+     * @return  Numero di nodi.
+     */
+    unsigned int nodesNumber() const {
+        return _nodes_number;
+    }
+
+    /**
+     * @brief Ritorna il numero di archi nel grafo.
+     * 
+     * @return  Numero di archi.
+     */
+    unsigned int edgesNumber() const {
+        return _edges_number;
+    }
+
+    /**
+     * @brief Impronta strutturale a 64 bit del grafo.
+     *
+     * Dipende dal numero di nodi e di archi, dal multinsieme dei gradi
+     * uscenti, dal numero di cappi e di coppie di archi opposti e dagli
+     * hash dei nodi e degli estremi di ogni arco. L'hash di un nodo è dato
+     * dal metodo hash(const T&) di E, se esiste, e deve essere coerente
+     * con E: nodi uguali per E devono avere lo stesso hash. Se E è
+     * std::equal_to<T> viene usato std::hash<T>, se disponibile;
+     * altrimenti tutti i nodi hanno hash 0 e contano solo i gradi.
+     * Grafi uguali (operator==) hanno quindi la stessa impronta anche con i
+     * nodi in ordine diverso, e può essere usata come chiave di una tabella
+     * hash; grafi diversi possono averla uguale, e vanno confrontati con
+     * operator==. L'impronta è aggiornata in O(n/64) da ogni modifica di
+     * un arco e ricalcolata solo quando la matrice viene ricostruita, quindi
+     * la lettura costa O(1).
+     */
+    std::uint64_t fingerprint() const {
+        return mixBits(_fingerprint + mixBits(_nodes_number ^
+                       (std::uint64_t(_edges_number) << 32)));
+    }
+
+    /**
+     * @brief Inserimento del nodo nel grafo.
+     * 
+     * Il nodo viene inserito privo di archi entranti e uscenti (nodo isolato).
+     * 
+     * @param node Nodo da inserire.
+     * @pre !exists(node)
+     * @throw Eccezione di allocazione di memoria.
+     */
+    void addNode(const T& node) {
+        assert(!exists(node));
+
+        record(NODE_ADDED, _nodes_number, 0, &node);
+        try {
+            insertAt(_nodes_number, node);
+        } catch(...) {
+            discardLast();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Eliminazione del nodo dal grafo.
+     * 
+     * Il nodo e tutti i relativi archi entranti o uscenti vengono rimossi dal
+     * grafo.
+     * 
+     * @param node Nodo da rimuovere.
+     * @pre exists(node)
+     * @throw Eccezione di allocazione di memoria.
+     */
+    void removeNode(const T& node) {
+        assert(exists(node));
+
+        const unsigned int k = nodeIndex(node);
+        record(NODE_REMOVED, k, 0, &_nodes[k]);
+        try {
+            removeAt(k);
+        } catch(...) {
+            discardLast();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Aggiunta dell'arco al grafo.
+     * 
+     * @param u Nodo sorgende dell'arco da aggiungere.
+     * @param v Nodo destinazione dell'arco da aggiungere.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @pre !hasEdge(u, v)
+     * @post hasEdge(u, v)
+     * @throw Eccezione di allocazione di memoria.
+     */
+    void addEdge(const T& u, const T& v) {
+        assert(!hasEdge(u, v));
+
+        const unsigned int i = nodeIndex(u);
+        const unsigned int j = nodeIndex(v);
+        record(EDGE_ADDED, i, j, nullptr);
+        try {
+            flipEdgeAt(i, j);
+        } catch(...) {
+            discardLast();
+            throw;
+        }
+        ++_edges_number;
+    }
+
+    /**
+     * @brief Eliminazione dell'arco dal grafo.
+     * 
+     * @param u Nodo sorgende dell'arco da rimuovere.
+     * @param v Nodo destinazione dell'arco da rimuovere.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @pre hasEdge(u, v)
+     * @post !hasEdge(u, v)
+     * @throw Eccezione di allocazione di memoria.
+     */
+    void removeEdge(const T& u, const T& v) {
+        assert(hasEdge(u, v));
+
+        const unsigned int i = nodeIndex(u);
+        const unsigned int j = nodeIndex(v);
+        record(EDGE_REMOVED, i, j, nullptr);
+        try {
+            flipEdgeAt(i, j);
+        } catch(...) {
+            discardLast();
+            throw;
+        }
+        --_edges_number;
+    }
+
+    /**
+     * @brief Determina l'esistenza di un nodo nel grafo. 
+     * 
+     * @param u Nodo da cercare.
+     * @return true se il nodo è presente nel grafo, false altrimenti.
+     */
+    bool exists(const T& u) const {
+        return nodeIndex(u) != _nodes_number;
+    }
+
+    /**
+     * @brief Determina l'esistenza di un arco nel grafo. 
+     * 
+     * @param u Nodo sorgende dell'arco da cercare.
+     * @param v Nodo destinazione dell'arco da cercare.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @return true se l'arco è presente nel grafo, false altrimenti.
+     */
+    bool hasEdge(const T& u, const T& v) const {
+        assert(exists(u));
+        assert(exists(v));
+
+        unsigned int u_index = nodeIndex(u);
+        unsigned int v_index = nodeIndex(v);
+
+        return edgeAt(u_index, v_index);
+    }
+
+    /**
+     * @brief Ritorna il numero di archi uscenti dal nodo.
+     * 
+     * Costo O(n/64) dopo la ricerca del nodo.
+     * 
+     * @param u Nodo di cui contare gli archi uscenti.
+     * @pre exists(u)
+     * @return Numero di successori di u.
+     */
+    unsigned int outDegree(const T& u) const {
+        assert(exists(u));
+
+        return outDegreeAt(nodeIndex(u));
+    }
+
+    /**
+     * @brief Ritorna il numero di archi entranti nel nodo.
+     * 
+     * Se la trasposta è mantenuta il costo è O(n/64), altrimenti viene letta
+     * una colonna della matrice di adiacenza in O(n).
+     * 
+     * @param v Nodo di cui contare gli archi entranti.
+     * @pre exists(v)
+     * @return Numero di predecessori di v.
+     */
+    unsigned int inDegree(const T& v) const {
+        assert(exists(v));
+
+        return inDegreeAt(nodeIndex(v));
+    }
+
+    /**
+     * @brief Ritorna il grafo trasposto, con tutti gli archi invertiti.
+     * 
+     * I nodi mantengono lo stesso ordine. La matrice viene trasposta a
+     * blocchi di 64x64 bit, costo O(n^2/64) parole lette e scritte una
+     * sola volta. Se il grafo mantiene la trasposta, il risultato ne
+     * condivide le fasce e gli identificativi, costo O(n/64).
+     * 
+     * @return Digraph trasposto, con lo stesso allocatore.
+     * @throw eccezione di allocazione della memoria
+     */
+    Digraph transpose() const {
+        if (_adj_transpose != nullptr) {
+            Digraph tmp(_alloc);
+            tmp.shareFrom(*this);
+            std::swap(tmp._adj_matrix, tmp._adj_transpose);
+            tmp.keepTranspose(false);
+            tmp.computeFingerprint();
+            return tmp;
+        }
+
+        Digraph tmp(_nodes_number, _alloc);
+
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            tmp.copyNode(i, *this, i);
+        }
+        transposeMatrix(_adj_matrix, tmp._adj_matrix, _nodes_number);
+        tmp._edges_number = _edges_number;
+        tmp.computeFingerprint();
+
+        return tmp;
+    }
+
+    /**
+     * @brief Sottografo indotto da una sequenza di nodi.
+     * 
+     * Il risultato contiene i nodi indicati e tutti gli archi del grafo tra
+     * di essi. I nodi mantengono l'ordine che hanno in *this, i duplicati
+     * nella sequenza vengono ignorati. La sequenza viene letta una volta per
+     * costruire una maschera di bit, dopodichè le righe selezionate vengono
+     * compattate in un solo passaggio.
+     * 
+     * @param first Iteratore al primo nodo.
+     * @param last Iteratore alla fine della sequenza di nodi.
+     * @pre exists(*i) per ogni nodo della sequenza
+     * @return Sottografo indotto, con lo stesso allocatore.
+     * @throw eccezione di allocazione della memoria
+     */
+    template <typename InputIt>
+    Digraph inducedSubgraph(InputIt first, InputIt last) const {
+        std::vector<bit_word> mask(_row_words, bit_word(0));
+
+        for (; first != last; ++first) {
+            const unsigned int i = nodeIndex(*first);
+            assert(i != _nodes_number);
+            mask[i / BIT_WORD_BITS] |= bit_word(1) << (i % BIT_WORD_BITS);
+        }
+
+        return inducedByMask(mask);
+    }
+
+    /**
+     * @brief Sottografo indotto dai nodi che soddisfano un predicato.
+     * 
+     * @param pred Predicato unario su const T&.
+     * @return Sottografo indotto, con i nodi nell'ordine di *this.
+     * @throw eccezione di allocazione della memoria
+     */
+    template <typename Pred>
+    Digraph inducedSubgraphIf(Pred pred) const {
+        std::vector<bit_word> mask(_row_words, bit_word(0));
+
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            if (pred(_nodes[i])) {
+                mask[i / BIT_WORD_BITS] |= bit_word(1) << (i % BIT_WORD_BITS);
+            }
+        }
+
+        return inducedByMask(mask);
+    }
+
+    /**
+     * @brief Conta i cicli orientati di lunghezza 3 (u -> v -> w -> u con
+     * nodi distinti).
+     *
+     * Le righe dei successori vengono confrontate con quelle dei
+     * predecessori con AND e popcount, dividendo le righe tra più thread.
+     * Costo O(m * n / 64); senza trasposta mantenuta ne viene calcolata una
+     * temporanea in O(n^2 / 64).
+     *
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @return Numero di triangoli orientati.
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    unsigned long long countTriangles(unsigned int threads = 0) const {
+        std::vector<unsigned long long> triangles(_nodes_number);
+        countCycles(triangles.data(), nullptr, threads);
+
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            total += triangles[i];
+        }
+        return total / 3;
+    }
+
+    /**
+     * @brief Conta le coppie di nodi distinti u, v con archi u -> v e
+     * v -> u (cicli di lunghezza 2).
+     *
+     * Costo O(n^2 / 64), con le righe divise tra più thread.
+     *
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @return Numero di coppie reciproche.
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    unsigned long long countReciprocalEdges(unsigned int threads = 0) const {
+        std::vector<unsigned int> reciprocal(_nodes_number);
+        countCycles(nullptr, reciprocal.data(), threads);
+
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            total += reciprocal[i];
+        }
+        return total / 2;
+    }
+
+    /**
+     * @brief Ritorna, per ogni nodo, i triangoli e le coppie reciproche a
+     * cui partecipa.
+     *
+     * L'elemento i-esimo si riferisce all'i-esimo nodo nell'ordine degli
+     * iteratori. La somma dei triangoli è 3 * countTriangles(), quella
+     * delle coppie reciproche 2 * countReciprocalEdges().
+     *
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    std::vector<CycleCounts> cycleParticipation(unsigned int threads = 0)
+            const {
+        std::vector<unsigned long long> triangles(_nodes_number);
+        std::vector<unsigned int> reciprocal(_nodes_number);
+        countCycles(triangles.data(), reciprocal.data(), threads);
+
+        std::vector<CycleCounts> counts(_nodes_number);
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            counts[i].triangles = triangles[i];
+            counts[i].reciprocal = reciprocal[i];
+        }
+        return counts;
+    }
+
+    /**
+     * @brief Prodotto tra la matrice di adiacenza e un vettore.
+     *
+     * L'elemento i-esimo del risultato è la somma di x[j] sui successori j
+     * dell'i-esimo nodo (sui predecessori se predecessors è true), con i
+     * nodi nell'ordine degli iteratori. È il passo delle iterazioni di
+     * pageRank e hitsScores. Le righe di bit vengono lette direttamente,
+     * costo O(n^2 / 64 + m), dividendole tra più thread. Con predecessors
+     * e senza trasposta mantenuta ne viene calcolata una temporanea.
+     *
+     * @param x Vettore di nodesNumber() valori, float o double.
+     * @param predecessors true per sommare sui predecessori.
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @return Vettore di nodesNumber() valori.
+     * @pre x.size() == nodesNumber()
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    template <typename V>
+    std::vector<V> multiply(const std::vector<V>& x,
+            bool predecessors = false, unsigned int threads = 0) const {
+        assert(x.size() == _nodes_number);
+        if (predecessors && _adj_transpose == nullptr &&
+                _nodes_number != 0) {
+            Digraph tmp(*this);
+            tmp.keepTranspose(true);
+            return tmp.multiply(x, true, threads);
+        }
+
+        std::vector<V> padded(std::size_t(_row_words) * BIT_WORD_BITS, V(0));
+        std::copy(x.begin(), x.end(), padded.begin());
+        std::vector<V> y(_nodes_number);
+        const index_vector none((index_alloc_type(_alloc)));
+        RowWorkers workers(_nodes_number, threads);
+        multiplyRows(predecessors ? _adj_transpose : _adj_matrix, none, none,
+                     padded.data(), y.data(), workers);
+        return y;
+    }
+
+    /**
+     * @brief PageRank dei nodi, nell'ordine degli iteratori.
+     *
+     * Iterazione delle potenze con il passo
+     * r'[v] = (1 - d) / n + d * (somma di r[u] / outDegree(u) sui
+     * predecessori u di v + somma di r[u] / n sui nodi senza successori),
+     * calcolato sulle righe della trasposta (temporanea se non mantenuta).
+     * Se il grafo ha in media meno di un arco per parola di riga, le righe
+     * vengono prima compresse e ogni iterazione costa O(n + m), altrimenti
+     * O(n^2 / 64 + m). L'iterazione termina quando la somma delle
+     * variazioni è minore di tolerance o dopo max_iterations passi.
+     *
+     * @param damping Fattore di smorzamento d, tra 0 e 1.
+     * @param tolerance Soglia di convergenza sulla norma 1 delle variazioni.
+     * @param max_iterations Numero massimo di iterazioni.
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @return Vettore di nodesNumber() valori di somma 1.
+     * @pre 0 <= damping <= 1
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    template <typename V = double>
+    std::vector<V> pageRank(V damping = V(0.85), V tolerance = V(1e-6),
+            unsigned int max_iterations = 100, unsigned int threads = 0)
+            const {
+        assert(damping >= V(0) && damping <= V(1));
+        if (_nodes_number == 0) {
+            return std::vector<V>();
+        }
+        if (_adj_transpose == nullptr) {
+            Digraph tmp(*this);
+            tmp.keepTranspose(true);
+            return tmp.pageRank(damping, tolerance, max_iterations, threads);
+        }
+
+        const unsigned int n = _nodes_number;
+        index_vector offsets((index_alloc_type(_alloc)));
+        index_vector indices((index_alloc_type(_alloc)));
+        if (sparseRows()) {
+            compressRows(_adj_transpose, offsets, indices);
+        }
+        std::vector<unsigned int> degree(n);
+        for (unsigned int i = 0; i < n; ++i) {
+            degree[i] = outDegreeAt(i);
+        }
+
+        std::vector<V> rank(n, V(1) / n);
+        std::vector<V> x(std::size_t(_row_words) * BIT_WORD_BITS, V(0));
+        std::vector<V> y(n);
+        RowWorkers workers(n, threads);
+        for (unsigned int it = 0; it < max_iterations; ++it) {
+            V dangling = V(0);
+            for (unsigned int i = 0; i < n; ++i) {
+                if (degree[i] == 0) {
+                    dangling += rank[i];
+                    x[i] = V(0);
+                }
+                else {
+                    x[i] = rank[i] / degree[i];
+                }
+            }
+            multiplyRows(_adj_transpose, offsets, indices, x.data(),
+                         y.data(), workers);
+
+            const V base = (V(1) - damping + damping * dangling) / n;
+            V delta = V(0);
+            for (unsigned int i = 0; i < n; ++i) {
+                const V r = base + damping * y[i];
+                delta += std::abs(r - rank[i]);
+                rank[i] = r;
+            }
+            if (delta < tolerance) {
+                break;
+            }
+        }
+        return rank;
+    }
+
+    /**
+     * @brief Punteggi hub e authority (HITS) dei nodi, nell'ordine degli
+     * iteratori.
+     *
+     * Ad ogni iterazione l'authority di v diventa la somma degli hub dei
+     * predecessori e l'hub di u la somma delle authority dei successori,
+     * entrambi normalizzati in norma euclidea. Usa le righe della matrice
+     * e della trasposta (temporanea se non mantenuta), compresse se il
+     * grafo è sparso come in pageRank. L'iterazione termina quando la
+     * somma delle variazioni è minore di tolerance o dopo max_iterations
+     * passi.
+     *
+     * @param hubs Sovrascritto con nodesNumber() punteggi hub.
+     * @param authorities Sovrascritto con nodesNumber() punteggi authority.
+     * @param tolerance Soglia di convergenza sulla norma 1 delle variazioni.
+     * @param max_iterations Numero massimo di iterazioni.
+     * @param threads Numero massimo di thread, 0 per usarne uno per core.
+     * @throw eccezione di allocazione della memoria o std::system_error
+     */
+    template <typename V>
+    void hitsScores(std::vector<V>& hubs, std::vector<V>& authorities,
+            V tolerance = V(1e-6), unsigned int max_iterations = 100,
+            unsigned int threads = 0) const {
+        if (_nodes_number != 0 && _adj_transpose == nullptr) {
+            Digraph tmp(*this);
+            tmp.keepTranspose(true);
+            tmp.hitsScores(hubs, authorities, tolerance, max_iterations,
+                           threads);
+            return;
+        }
+
+        const unsigned int n = _nodes_number;
+        index_vector succ_offsets((index_alloc_type(_alloc)));
+        index_vector succ_indices((index_alloc_type(_alloc)));
+        index_vector pred_offsets((index_alloc_type(_alloc)));
+        index_vector pred_indices((index_alloc_type(_alloc)));
+        if (sparseRows()) {
+            compressRows(_adj_matrix, succ_offsets, succ_indices);
+            compressRows(_adj_transpose, pred_offsets, pred_indices);
+        }
+
+        hubs.assign(n, n == 0 ? V(0) : V(1) / std::sqrt(V(n)));
+        authorities.assign(n, V(0));
+        std::vector<V> x(std::size_t(_row_words) * BIT_WORD_BITS, V(0));
+        std::vector<V> y(n);
+        RowWorkers workers(n, threads);
+        for (unsigned int it = 0; it < max_iterations && n != 0; ++it) {
+            V delta = V(0);
+
+            std::copy(hubs.begin(), hubs.end(), x.begin());
+            multiplyRows(_adj_transpose, pred_offsets, pred_indices,
+                         x.data(), y.data(), workers);
+            normalize(y);
+            for (unsigned int i = 0; i < n; ++i) {
+                delta += std::abs(y[i] - authorities[i]);
+            }
+            authorities.swap(y);
+
+            std::copy(authorities.begin(), authorities.end(), x.begin());
+            multiplyRows(_adj_matrix, succ_offsets, succ_indices, x.data(),
+                         y.data(), workers);
+            normalize(y);
+            for (unsigned int i = 0; i < n; ++i) {
+                delta += std::abs(y[i] - hubs[i]);
+            }
+            hubs.swap(y);
+
+            if (delta < tolerance) {
+                break;
+            }
+        }
+    }
 
     /**
-     * @brief Costruttore di copia.
-     * 
-     * @param other Digraph da copiare
+     * @brief Albero dei dominatori dei nodi raggiungibili da root.
+     *
+     * Algoritmo iterativo di Cooper, Harvey e Kennedy. Una visita in
+     * profondità iterativa da root scorre le righe di bit dei successori,
+     * numera i nodi in postordine e raccoglie i predecessori dei nodi
+     * raggiungibili in formato compresso, senza usare la trasposta; poi i
+     * dominatori immediati vengono raffinati in ordine postordine inverso
+     * intersecando i cammini nell'albero dei predecessori già elaborati,
+     * finché non cambiano più. Costo O(n^2/64 + m) per la visita più
+     * O(m) per passata, di solito poche passate; tutte le scansioni usano
+     * posizioni e non il funtore E.
+     *
+     * @param root Radice, ad esempio il nodo di ingresso di un flusso.
+     * @return Albero con i nodi indicati per posizione, nell'ordine degli
+     * iteratori.
+     * @pre exists(root)
      * @throw eccezione di allocazione della memoria
      */
-    Digraph(const Digraph& other) : _nodes(nullptr), _nodes_number(0),
-            _adj_matrix(nullptr), _edges_number(0) {
-        Digraph tmp(other._nodes_number);
+    DominatorTree dominatorTree(const T& root) const {
+        assert(exists(root));
+        const unsigned int n = _nodes_number;
+        const unsigned int r = nodeIndex(root);
 
-        try {
-            for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
-                tmp._nodes[i] = other._nodes[i];
+        // Visita in profondità: postordine e predecessori
+        struct Frame {
+            unsigned int node; ///< Nodo visitato
+            unsigned int word; ///< Parola corrente della sua riga
+            bit_word bits; ///< Successori non ancora esaminati nella parola
+        };
+        std::vector<unsigned int> post(n, NONE);
+        std::vector<unsigned int> order; // Nodi in postordine
+        std::vector<bit_word> visited(_row_words, bit_word(0));
+        std::vector<std::pair<unsigned int, unsigned int> > edges;
+        std::vector<Frame> stack;
+
+        Frame top = {r, 0, row(r)[0]};
+        stack.push_back(top);
+        flipBit(&visited[0], r);
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            if (f.bits == 0) {
+                const bit_word* successors = row(f.node);
+                unsigned int w = f.word + 1;
+                while (w < _row_words && successors[w] == 0) {
+                    ++w;
+                }
+                if (w < _row_words) {
+                    f.word = w;
+                    f.bits = successors[w];
+                }
             }
-        } catch(...) {
-            tmp.clear();
-            throw;
+            if (f.bits == 0) {
+                post[f.node] = static_cast<unsigned int>(order.size());
+                order.push_back(f.node);
+                stack.pop_back();
+                continue;
+            }
+            const unsigned int v = f.word * BIT_WORD_BITS + lowestBit(f.bits);
+            f.bits &= f.bits - 1;
+            edges.push_back(std::make_pair(v, f.node));
+            if (!testBit(&visited[0], v)) {
+                flipBit(&visited[0], v);
+                Frame next = {v, 0, row(v)[0]};
+                stack.push_back(next);
+            }
+        }
+
+        // Predecessori in formato compresso, per numero di postordine
+        const unsigned int k = static_cast<unsigned int>(order.size());
+        std::vector<unsigned int> first(k + 1, 0);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            ++first[post[edges[e].first] + 1];
+        }
+        for (unsigned int i = 0; i < k; ++i) {
+            first[i + 1] += first[i];
+        }
+        std::vector<unsigned int> preds(edges.size());
+        std::vector<unsigned int> fill(first.begin(), first.end() - 1);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            preds[fill[post[edges[e].first]]++] = post[edges[e].second];
         }
 
-        for (unsigned int i=0; i < tmp._nodes_number; ++i) {
-            for (unsigned int j=0; j < tmp._nodes_number; ++j) {
-                tmp._adj_matrix[i][j] = other._adj_matrix[i][j];
+        // Cooper, Harvey, Kennedy sui numeri di postordine: la radice ha
+        // il numero k - 1, più alto di tutti
+        std::vector<unsigned int> idom(k, NONE);
+        idom[k - 1] = k - 1;
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (unsigned int b = k - 1; b-- > 0; ) {
+                unsigned int candidate = NONE;
+                for (unsigned int p = first[b]; p < first[b + 1]; ++p) {
+                    unsigned int other = preds[p];
+                    if (idom[other] == NONE) {
+                        continue;
+                    }
+                    if (candidate == NONE) {
+                        candidate = other;
+                        continue;
+                    }
+                    while (other != candidate) {
+                        while (other < candidate) {
+                            other = idom[other];
+                        }
+                        while (candidate < other) {
+                            candidate = idom[candidate];
+                        }
+                    }
+                }
+                if (idom[b] != candidate) {
+                    idom[b] = candidate;
+                    changed = true;
+                }
             }
         }
-        tmp._edges_number = other._edges_number;
 
-        swap(tmp);
+        std::vector<unsigned int> result(n, DominatorTree::NONE);
+        for (unsigned int b = 0; b + 1 < k; ++b) {
+            result[order[b]] = order[idom[b]];
+        }
+        return DominatorTree(r, std::move(result));
     }
 
     /**
-     * @brief Distruttore.
+     * @brief Attiva o disattiva il mantenimento della trasposta.
      * 
-     * Dealloca tutte le risorse allocate dinamicamente.
-     * 
-     * @post _nodes == nullptr
-     * @post _nodes_number == 0
-     * @post _adjacent_matrix == nullptr
-     * @post _edges_number == 0
-     */
-    ~Digraph() {
-        clear();
-    }
-
-    /**
-     * @brief Operatore di assegnamento.
+     * Con la trasposta attiva i predecessori di un nodo sono memorizzati in
+     * una riga contigua come i successori, al costo di raddoppiare la
+     * memoria della matrice. Ogni modifica aggiorna entrambe le matrici.
      * 
-     * @param other Digraph da assegnare.
-     * @return reference al Digraph this.
-     * @throw Eccezione di allocazione della memoria.
+     * @param keep true per mantenere la trasposta, false per liberarla.
+     * @throw eccezione di allocazione della memoria
      */
-    Digraph& operator= (const Digraph& other) {
-        if (this != &other) {
-            Digraph tmp(other);
-            this->swap(tmp);
+    void keepTranspose(bool keep) {
+        if (keep && !_keep_transpose && _nodes_number != 0) {
+            bit_word** transposed = allocateMatrix(_nodes_number);
+            transposeMatrix(_adj_matrix, transposed, _nodes_number);
+            _adj_transpose = transposed;
+            S::countAllocated(matrixBytes());
         }
-        return *this;
+        else if (!keep && _keep_transpose) {
+            deallocateMatrix(_adj_transpose, _nodes_number);
+            _adj_transpose = nullptr;
+        }
+        _keep_transpose = keep;
     }
 
     /**
-     * @brief Swap tra *this e il Digraph other.
-     * 
-     * @param other Digraph con cui eseguire la swap
+     * @brief Ritorna true se il grafo mantiene la trasposta.
      */
-    void swap(Digraph& other) {
-        std::swap(_nodes, other._nodes);
-        std::swap(_nodes_number, other._nodes_number);
-        std::swap(_adj_matrix, other._adj_matrix);
-        std::swap(_edges_number, other._edges_number);
+    bool keepsTranspose() const {
+        return _keep_transpose;
     }
 
     /**
-     * @brief Ritorna il numero di nodi nel grafo.
-     * 
-     * @return  Numero di nodi.
+     * @brief Suggerisce che le righe di u verranno lette a breve.
+     *
+     * Pensata per le visite: chiamata sui nodi della frontiera prima di
+     * espanderli, permette all'allocatore di caricare in anticipo le righe
+     * dei successori e, se la trasposta è mantenuta, dei predecessori.
+     * Ha effetto solo con allocatori che forniscono willNeed, come
+     * MappedAllocator; con gli altri non fa nulla.
+     *
+     * @param u Nodo di cui verranno lette le righe.
+     * @pre exists(u)
      */
-    unsigned int nodesNumber() const {
-        return _nodes_number;
-    }
+    void prefetch(const T& u) const {
+        assert(exists(u));
+        const unsigned int i = nodeIndex(u);
+        const std::size_t bytes = std::size_t(_row_words) * sizeof(bit_word);
 
-    /**
-     * @brief Ritorna il numero di archi nel grafo.
-     * 
-     * @return  Numero di archi.
-     */
-    unsigned int edgesNumber() const {
-        return _edges_number;
+        adviseWillNeed(_alloc, row(i), bytes, 0);
+        if (_adj_transpose != nullptr) {
+            adviseWillNeed(_alloc, transposedRow(i), bytes, 0);
+        }
     }
 
     /**
-     * @brief Inserimento del nodo nel grafo.
-     * 
-     * Il nodo viene inserito privo di archi entranti e uscenti (nodo isolato).
-     * 
-     * @param node Nodo da inserire.
-     * @pre !exists(node)
-     * @throw Eccezione di allocazione di memoria.
+     * @brief Attiva o disattiva la modalità di scansione sequenziale.
+     *
+     * Da attivare prima degli algoritmi che leggono tutte le righe in
+     * ordine: l'allocatore può leggere in anticipo le fasce successive e
+     * liberare quelle già lette. Ha effetto solo con allocatori che
+     * forniscono sequential, come MappedAllocator; con gli altri non fa
+     * nulla. Le fasce allocate dopo la chiamata non sono interessate.
+     *
+     * @param on true per la scansione sequenziale, false per l'accesso
+     * normale.
      */
-    void addNode(const T& node) {
-        assert(!exists(node));
-
-        Digraph tmp(_nodes_number + 1);
-
-        try {
-            for (unsigned int i = 0; i < _nodes_number; ++i) {
-                tmp._nodes[i] = _nodes[i];
-            }
-            tmp._nodes[_nodes_number] = node;
-        } catch(...) {
-            tmp.clear();
-            throw;
-        }
-
-        for (unsigned int i = 0; i < _nodes_number; ++i) {
-            for (unsigned int j = 0; j < _nodes_number; ++j) {
-                tmp._adj_matrix[i][j] = _adj_matrix[i][j];
+    void sequentialScan(bool on) const {
+        for (unsigned int b = 0; b < bandsNumber(_nodes_number); ++b) {
+            const std::size_t bytes = bandWords(_nodes_number, b) *
+                                      sizeof(bit_word);
+            adviseSequential(_alloc, _adj_matrix[b], bytes, on, 0);
+            if (_adj_transpose != nullptr) {
+                adviseSequential(_alloc, _adj_transpose[b], bytes, on, 0);
             }
         }
-        for (unsigned int i = 0; i < _nodes_number; ++i) {
-            tmp._adj_matrix[i][_nodes_number] = false;
-            tmp._adj_matrix[_nodes_number][i] = false;
-        }
-        tmp._edges_number = _edges_number;
-
-        this->swap(tmp);
     }
 
     /**
-     * @brief Eliminazione del nodo dal grafo.
+     * @brief Attiva o disattiva il journal delle modifiche.
      * 
-     * Il nodo e tutti i relativi archi entranti o uscenti vengono rimossi dal
-     * grafo.
+     * Con il journal attivo addNode, removeNode, addEdge e removeEdge
+     * vengono registrate come differenze e possono essere annullate con
+     * rollback e riapplicate con redo. Un arco occupa una voce di dimensione
+     * fissa, un nodo rimosso anche le posizioni dei suoi vicini.
+     * Il journal parte vuoto; disattivarlo scarta tutte le voci.
+     * Le copie del grafo non ereditano il journal.
      * 
-     * @param node Nodo da rimuovere.
-     * @pre exists(node)
-     * @throw Eccezione di allocazione di memoria.
+     * @param keep true per attivare il journal, false per disattivarlo.
+     * @throw eccezione di allocazione della memoria
      */
-    void removeNode(const T& node) {
-        assert(exists(node));
-
-        Digraph tmp(_nodes_number - 1);
-        unsigned int node_index = nodeIndex(node);
-
-        try {
-            for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
-                tmp._nodes[i] = (i < node_index) ? _nodes[i] : _nodes[i+1];
+    void keepJournal(bool keep) {
+        if (keep && _journal == nullptr) {
+            journal_alloc_type journal_alloc(_alloc);
+            Journal* journal = journal_traits::allocate(journal_alloc, 1);
+            try {
+                journal_traits::construct(journal_alloc, journal, _alloc);
+            } catch(...) {
+                journal_traits::deallocate(journal_alloc, journal, 1);
+                throw;
             }
-        } catch(...) {
-            tmp.clear();
-            throw;
+            _journal = journal;
         }
-
-        unsigned int k, l;
-        for (unsigned int i = 0; i < tmp._nodes_number; ++i) {
-            for (unsigned int j = 0; j < tmp._nodes_number; ++j) {
-                k = (i < node_index) ? i : i+1;
-                l = (j < node_index) ? j : j+1;
-                
-                tmp._adj_matrix[i][j] = _adj_matrix[k][l];
-                
-                if (tmp._adj_matrix[i][j]) {
-                    ++tmp._edges_number;
-                }
-            }
+        else if (!keep) {
+            freeJournal();
         }
-
-        this->swap(tmp);
     }
 
     /**
-     * @brief Aggiunta dell'arco al grafo.
-     * 
-     * @param u Nodo sorgende dell'arco da aggiungere.
-     * @param v Nodo destinazione dell'arco da aggiungere.
-     * @pre exists(u)
-     * @pre exists(v)
-     * @pre !hasEdge(u, v)
-     * @post hasEdge(u, v)
+     * @brief Ritorna true se il journal delle modifiche è attivo.
      */
-    void addEdge(const T& u, const T& v) {
-        assert(!hasEdge(u, v));
-
-        setEdge(u, v);
-        ++_edges_number;
+    bool keepsJournal() const {
+        return _journal != nullptr;
     }
 
     /**
-     * @brief Eliminazione dell'arco dal grafo.
+     * @brief Tipo dei checkpoint del journal.
+     */
+    typedef std::size_t checkpoint_type;
+
+    /**
+     * @brief Ritorna un checkpoint dello stato corrente del grafo.
      * 
-     * @param u Nodo sorgende dell'arco da rimuovere.
-     * @param v Nodo destinazione dell'arco da rimuovere.
-     * @pre exists(u)
-     * @pre exists(v)
-     * @pre hasEdge(u, v)
-     * @post !hasEdge(u, v)
+     * Costo O(1), il checkpoint è il numero di modifiche applicate.
+     * 
+     * @pre keepsJournal()
+     * @return Checkpoint da passare a rollback.
      */
-    void removeEdge(const T& u, const T& v) {
-        assert(hasEdge(u, v));
+    checkpoint_type checkpoint() const {
+        assert(keepsJournal());
 
-        setEdge(u, v);
-        --_edges_number;
+        return _journal->position;
     }
 
     /**
-     * @brief Determina l'esistenza di un nodo nel grafo. 
+     * @brief Riporta il grafo allo stato del checkpoint cp.
      * 
-     * @param u Nodo da cercare.
-     * @return true se il nodo è presente nel grafo, false altrimenti.
+     * Le modifiche successive a cp vengono annullate in ordine inverso,
+     * ognuna con il costo della modifica stessa: O(1) per gli archi, una
+     * ricostruzione per i nodi. Le modifiche annullate restano nel journal
+     * e possono essere riapplicate con redo fino alla prossima modifica.
+     * Ogni modifica viene annullata per intero o per niente: se viene
+     * lanciata un'eccezione il grafo resta allo stato di checkpoint().
+     * 
+     * @param cp Checkpoint ottenuto da checkpoint().
+     * @pre keepsJournal()
+     * @pre cp <= checkpoint()
+     * @post checkpoint() == cp
+     * @throw eccezione di allocazione della memoria
      */
-    bool exists(const T& u) const {
-        return nodeIndex(u) != _nodes_number;
+    void rollback(checkpoint_type cp) {
+        assert(keepsJournal());
+        assert(cp <= _journal->position);
+
+        while (_journal->position > cp) {
+            undoEntry(_journal->entries[_journal->position - 1]);
+            --_journal->position;
+        }
     }
 
     /**
-     * @brief Determina l'esistenza di un arco nel grafo. 
+     * @brief Riapplica la prima modifica annullata da rollback.
      * 
-     * @param u Nodo sorgende dell'arco da cercare.
-     * @param v Nodo destinazione dell'arco da cercare.
-     * @pre exists(u)
-     * @pre exists(v)
-     * @return true se l'arco è presente nel grafo, false altrimenti.
+     * La modifica viene riapplicata per intero o per niente: se viene
+     * lanciata un'eccezione il grafo e checkpoint() restano invariati.
+     * 
+     * @pre keepsJournal()
+     * @return false se non ci sono modifiche da riapplicare.
+     * @throw eccezione di allocazione della memoria
      */
-    bool hasEdge(const T& u, const T& v) const {
-        assert(exists(u));
-        assert(exists(v));
+    bool redo() {
+        assert(keepsJournal());
 
-        unsigned int u_index = nodeIndex(u);
-        unsigned int v_index = nodeIndex(v);
-
-        return _adj_matrix[u_index][v_index];
+        if (_journal->position == _journal->entries.size()) {
+            return false;
+        }
+        redoEntry(_journal->entries[_journal->position]);
+        ++_journal->position;
+        return true;
     }
 
     /**
@@ -475,35 +2948,275 @@ public:
 
 }; //class Digraph
 
+template <typename T, typename E, typename A, typename S>
+const unsigned int Digraph<T,E,A,S>::NONE;
+
+template <typename T, typename E, typename A, typename S>
+const unsigned int Digraph<T,E,A,S>::BAND_ROWS;
+
+template <typename T, typename E, typename A, typename S>
+const std::uint64_t Digraph<T,E,A,S>::LOOP_TERM;
+
+template <typename T, typename E, typename A, typename S>
+const std::uint64_t Digraph<T,E,A,S>::RECIPROCAL_TERM;
+
 /**
  * @brief Invia il Digraph sullo stream
  * 
  * Ridefinizione dell'operatore di stream per l'invio del contenuto del
  * Digraph sullo stream rappresentato come matrice di adiacenza.
  * 
+ * La matrice viene letta direttamente per indice, senza passare da hasEdge,
+ * e ogni riga viene composta in un buffer e inviata con una sola scrittura.
+ * Costo O(n^2).
+ * 
  * @param os Stream di output
  * @param digraph Digraph da inviare
  * @return Reference allo stream di output
  */
-template <typename T, typename E>
-std::ostream& operator<<(std::ostream& os, const Digraph<T,E>& digraph) {
-    typename Digraph<T,E>::const_iterator i_row = digraph.begin(),
-                                          i_col = digraph.begin();
+template <typename T, typename E, typename A, typename S>
+std::ostream& operator<<(std::ostream& os,
+        const Digraph<T,E,A,S>& digraph) {
+    const unsigned int n = digraph._nodes_number;
+    std::string row(2 * n, '\t');
+
+    for (unsigned int i = 0; i < n; ++i) {
+        os << '\t' << digraph._nodes[i];
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) {
+            row[2 * j + 1] = digraph.edgeAt(i, j) ? '1' : '0';
+        }
+        os << '\n' << digraph._nodes[i];
+        os.write(row.data(), row.size());
+    }
+
+    return os;
+}
+
+/**
+ * @brief Invia il Digraph sullo stream come lista di archi.
+ * 
+ * Ogni arco occupa una riga nel formato "u v". Vengono scritti solo gli archi
+ * presenti, quindi l'output ha dimensione O(m); le righe della matrice
+ * vengono lette una parola alla volta, la scansione costa O(n^2/64).
+ * 
+ * @param os Stream di output
+ * @param digraph Digraph da inviare
+ * @return Reference allo stream di output
+ */
+template <typename T, typename E, typename A, typename S>
+std::ostream& writeEdgeList(std::ostream& os,
+        const Digraph<T,E,A,S>& digraph) {
+    const unsigned int n = digraph._nodes_number;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        const bit_word* row = digraph.row(i);
+        for (unsigned int w = 0; w < digraph._row_words; ++w) {
+            for (bit_word bits = row[w]; bits != 0; bits &= bits - 1) {
+                const unsigned int j = w * BIT_WORD_BITS + lowestBit(bits);
+                os << digraph._nodes[i] << ' ' << digraph._nodes[j] << '\n';
+            }
+        }
+    }
+
+    return os;
+}
+
+/**
+ * @brief Invia il Digraph sullo stream in formato Graphviz DOT.
+ * 
+ * I nodi vengono identificati dalla loro posizione ("n0", "n1", ...) e
+ * l'identificativo di tipo T viene usato come etichetta, così da non dover
+ * imporre vincoli sul formato di T. Anche i nodi isolati vengono scritti.
+ * Output O(n + m), scansione O(n^2/64).
+ * 
+ * @param os Stream di output
+ * @param digraph Digraph da inviare
+ * @return Reference allo stream di output
+ */
+template <typename T, typename E, typename A, typename S>
+std::ostream& writeDot(std::ostream& os,
+        const Digraph<T,E,A,S>& digraph) {
+    const unsigned int n = digraph._nodes_number;
+    std::ostringstream label;
+    std::string escaped;
+
+    os << "digraph {\n";
+    for (unsigned int i = 0; i < n; ++i) {
+        label.str("");
+        label << digraph._nodes[i];
+
+        escaped.clear();
+        const std::string raw = label.str();
+        for (std::string::size_type k = 0; k < raw.size(); ++k) {
+            if (raw[k] == '"' || raw[k] == '\\') {
+                escaped += '\\';
+            }
+            escaped += raw[k];
+        }
 
-    for (i_col  = digraph.begin(); i_col != digraph.end(); ++i_col) {
-        os << "\t" << *i_col;        
+        os << "  n" << i << " [label=\"" << escaped << "\"];\n";
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+        const bit_word* row = digraph.row(i);
+        for (unsigned int w = 0; w < digraph._row_words; ++w) {
+            for (bit_word bits = row[w]; bits != 0; bits &= bits - 1) {
+                const unsigned int j = w * BIT_WORD_BITS + lowestBit(bits);
+                os << "  n" << i << " -> n" << j << ";\n";
+            }
+        }
     }
+    os << "}\n";
+
+    return os;
+}
+
+/**
+ * @brief Invia il Digraph sullo stream in formato Matrix Market.
+ * 
+ * Viene scritta una matrice sparsa "coordinate pattern general" n x n con un
+ * elemento per ogni arco, gli indici sono le posizioni dei nodi a partire
+ * da 1. Output O(m), scansione O(n^2/64).
+ * 
+ * @param os Stream di output
+ * @param digraph Digraph da inviare
+ * @return Reference allo stream di output
+ */
+template <typename T, typename E, typename A, typename S>
+std::ostream& writeMatrixMarket(std::ostream& os,
+        const Digraph<T,E,A,S>& digraph) {
+    const unsigned int n = digraph._nodes_number;
 
-    for (i_row  = digraph.begin(); i_row != digraph.end(); ++i_row) {
-        os << std::endl;
-        os << *i_row;
-        for (i_col  = digraph.begin(); i_col != digraph.end(); ++i_col)
-        {
-            os << "\t" << digraph.hasEdge(*i_row, *i_col);
+    os << "%%MatrixMarket matrix coordinate pattern general\n";
+    os << n << ' ' << n << ' ' << digraph._edges_number << '\n';
+    for (unsigned int i = 0; i < n; ++i) {
+        const bit_word* row = digraph.row(i);
+        for (unsigned int w = 0; w < digraph._row_words; ++w) {
+            for (bit_word bits = row[w]; bits != 0; bits &= bits - 1) {
+                const unsigned int j = w * BIT_WORD_BITS + lowestBit(bits);
+                os << (i + 1) << ' ' << (j + 1) << '\n';
+            }
         }
     }
 
     return os;
 }
 
+/**
+ * @brief Ritorna true se a e b hanno gli stessi nodi, secondo E, e gli
+ * stessi archi, indipendentemente dall'ordine dei nodi.
+ * 
+ * I grafi con numero di nodi, numero di archi o impronta diversi vengono
+ * scartati in O(1). Se i nodi sono nello stesso ordine le matrici vengono
+ * confrontate con memcmp, O(n^2/64), saltando le fasce condivise;
+ * altrimenti i nodi vengono allineati con O(n^2) confronti e ogni riga di b
+ * rinumerata e confrontata con quella di a.
+ * 
+ * @param a Primo grafo.
+ * @param b Secondo grafo.
+ */
+template <typename T, typename E, typename A, typename S>
+bool operator==(const Digraph<T,E,A,S>& a, const Digraph<T,E,A,S>& b) {
+    return a.equals(b);
+}
+
+/**
+ * @brief Ritorna true se a e b hanno nodi o archi diversi.
+ */
+template <typename T, typename E, typename A, typename S>
+bool operator!=(const Digraph<T,E,A,S>& a, const Digraph<T,E,A,S>& b) {
+    return !(a == b);
+}
+
+/**
+ * @brief Unione di due grafi.
+ * 
+ * Il risultato contiene i nodi di a seguiti dai nodi di b non presenti in a,
+ * e tutti gli archi presenti in almeno uno dei due grafi.
+ * Se a e b hanno gli stessi nodi nello stesso ordine l'unione costa
+ * O(n^2/64) operazioni su parole.
+ * 
+ * @param a Primo grafo.
+ * @param b Secondo grafo.
+ * @return Grafo unione, con l'allocatore di a.
+ * @throw eccezione di allocazione della memoria
+ */
+template <typename T, typename E, typename A, typename S>
+Digraph<T,E,A,S> graphUnion(const Digraph<T,E,A,S>& a,
+        const Digraph<T,E,A,S>& b) {
+    return Digraph<T,E,A,S>::combine(a, b,
+        [](bit_word x, bit_word y) { return x | y; },
+        Digraph<T,E,A,S>::NODES_UNION);
+}
+
+/**
+ * @brief Intersezione di due grafi.
+ * 
+ * Il risultato contiene i nodi presenti in entrambi i grafi, nell'ordine di
+ * a, e gli archi presenti in entrambi.
+ * 
+ * @param a Primo grafo.
+ * @param b Secondo grafo.
+ * @return Grafo intersezione, con l'allocatore di a.
+ * @throw eccezione di allocazione della memoria
+ */
+template <typename T, typename E, typename A, typename S>
+Digraph<T,E,A,S> graphIntersection(const Digraph<T,E,A,S>& a,
+        const Digraph<T,E,A,S>& b) {
+    return Digraph<T,E,A,S>::combine(a, b,
+        [](bit_word x, bit_word y) { return x & y; },
+        Digraph<T,E,A,S>::NODES_COMMON);
+}
+
+/**
+ * @brief Differenza tra due grafi.
+ * 
+ * Il risultato contiene i nodi di a e gli archi di a non presenti in b.
+ * 
+ * @param a Primo grafo.
+ * @param b Secondo grafo.
+ * @return Grafo differenza, con l'allocatore di a.
+ * @throw eccezione di allocazione della memoria
+ */
+template <typename T, typename E, typename A, typename S>
+Digraph<T,E,A,S> graphDifference(const Digraph<T,E,A,S>& a,
+        const Digraph<T,E,A,S>& b) {
+    return Digraph<T,E,A,S>::combine(a, b,
+        [](bit_word x, bit_word y) { return x & ~y; },
+        Digraph<T,E,A,S>::NODES_FIRST);
+}
+
+/**
+ * @brief Differenza simmetrica tra due grafi.
+ * 
+ * Il risultato contiene i nodi di entrambi i grafi, come graphUnion, e gli
+ * archi presenti in esattamente uno dei due.
+ * 
+ * @param a Primo grafo.
+ * @param b Secondo grafo.
+ * @return Grafo differenza simmetrica, con l'allocatore di a.
+ * @throw eccezione di allocazione della memoria
+ */
+template <typename T, typename E, typename A, typename S>
+Digraph<T,E,A,S> symmetricDifference(const Digraph<T,E,A,S>& a,
+        const Digraph<T,E,A,S>& b) {
+    return Digraph<T,E,A,S>::combine(a, b,
+        [](bit_word x, bit_word y) { return x ^ y; },
+        Digraph<T,E,A,S>::NODES_UNION);
+}
+
+#if __cplusplus >= 201703L
+#include <memory_resource> // std::pmr::polymorphic_allocator
+
+/**
+ * @brief Digraph che ottiene la memoria da una std::pmr::memory_resource.
+ * 
+ * Disponibile solo compilando con C++17 o successivi.
+ */
+template <typename T, typename E>
+using PmrDigraph = Digraph<T, E, std::pmr::polymorphic_allocator<T> >;
+#endif
+
 #endif //digraph_h
\ No newline at end of file
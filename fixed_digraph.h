@@ -0,0 +1,450 @@
+#ifndef fixed_digraph_h
+#define fixed_digraph_h
+
+#include <cassert> // assert
+#include <ostream> // std::ostream
+#include <string> // std::string
+
+#include "bits.h"
+
+
+/**
+ * @brief Grafo orientato di capacità fissa N, senza allocazioni dinamiche.
+ *
+ * Variante di Digraph con la stessa interfaccia pubblica (senza allocatore,
+ * statistiche e trasposta mantenuta, che non hanno senso senza heap).
+ * Nodi e matrice di adiacenza sono memorizzati all'interno dell'oggetto: una
+ * riga di bitWords(N) parole per nodo, con lo stesso formato di Digraph.
+ * Per N <= 64 ogni riga è una sola parola, quindi le visite e la chiusura
+ * transitiva si riducono a poche operazioni tra registri.
+ *
+ * Da C++14 tutti i metodi sono constexpr: se T e E lo permettono (tipi
+ * letterali, operator() constexpr) il grafo può essere costruito e
+ * interrogato a tempo di compilazione.
+ *
+ * @param T tipo dei nodi, default costruibile
+ * @param E funtore di uguaglianza tra due nodi
+ * @param N numero massimo di nodi
+ */
+template <typename T, typename E, unsigned int N>
+class FixedDigraph {
+    static_assert(N > 0, "FixedDigraph richiede N > 0");
+
+    /**
+     * @brief Parole per riga della matrice.
+     */
+    static const unsigned int WORDS = (N + BIT_WORD_BITS - 1) / BIT_WORD_BITS;
+
+    T _nodes[N]; ///< Identificativi dei nodi, validi i primi _nodes_number
+    bit_word _rows[N][WORDS]; ///< Matrice di adiacenza, una riga per nodo
+    unsigned int _nodes_number; ///< Numero di nodi
+    unsigned int _edges_number; ///< Numero di archi
+
+    E _equal; ///< Istanza del funtore di uguaglianza
+
+    template <typename U, typename F, unsigned int M>
+    friend std::ostream& operator<<(std::ostream& os,
+        const FixedDigraph<U,F,M>& digraph);
+
+    /**
+     * @brief Ritorna la posizione del nodo, nodesNumber() se assente.
+     */
+    BITS_CONSTEXPR unsigned int nodeIndex(const T& node) const {
+        unsigned int i = 0;
+        while (i < _nodes_number && !_equal(_nodes[i], node)) {
+            ++i;
+        }
+        return i;
+    }
+
+    /**
+     * @brief Ritorna true se esiste l'arco tra i nodi in posizione i e j.
+     */
+    BITS_CONSTEXPR bool edgeAt(unsigned int i, unsigned int j) const {
+        return testBit(_rows[i], j);
+    }
+
+    /**
+     * @brief Numero di successori del nodo in posizione i.
+     */
+    BITS_CONSTEXPR unsigned int outDegreeAt(unsigned int i) const {
+        return rowCount(_rows[i], WORDS);
+    }
+
+    /**
+     * @brief Numero di predecessori del nodo in posizione j.
+     */
+    BITS_CONSTEXPR unsigned int inDegreeAt(unsigned int j) const {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            count += edgeAt(i, j) ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Insieme dei nodi raggiungibili da i con cammini di lunghezza
+     * almeno 1.
+     *
+     * Visita in ampiezza sulle righe: la frontiera è l'OR delle righe dei
+     * nodi appena raggiunti, privata di quelli già visti.
+     *
+     * @param i Posizione del nodo di partenza.
+     * @param seen Riga di WORDS parole in cui scrivere il risultato.
+     */
+    BITS_CONSTEXPR void reachableAt(unsigned int i, bit_word* seen) const {
+        bit_word frontier[WORDS] = {};
+        bool more = false;
+
+        for (unsigned int w = 0; w < WORDS; ++w) {
+            seen[w] = frontier[w] = _rows[i][w];
+            more = more || frontier[w] != 0;
+        }
+
+        while (more) {
+            bit_word next[WORDS] = {};
+            for (unsigned int w = 0; w < WORDS; ++w) {
+                for (bit_word bits = frontier[w]; bits != 0;
+                        bits &= bits - 1) {
+                    const unsigned int k = w * BIT_WORD_BITS + lowestBit(bits);
+                    for (unsigned int x = 0; x < WORDS; ++x) {
+                        next[x] |= _rows[k][x];
+                    }
+                }
+            }
+
+            more = false;
+            for (unsigned int w = 0; w < WORDS; ++w) {
+                frontier[w] = next[w] & ~seen[w];
+                seen[w] |= next[w];
+                more = more || frontier[w] != 0;
+            }
+        }
+    }
+
+public:
+    typedef const T* const_iterator; ///< Iteratore costante sui nodi
+
+    /**
+     * @brief Costruttore default, genera un grafo vuoto.
+     */
+    BITS_CONSTEXPR FixedDigraph() : _nodes(), _rows(), _nodes_number(0),
+            _edges_number(0), _equal() {}
+
+    /**
+     * @brief Costruttore che genera un grafo con i nodi indicati e privo di
+     * archi.
+     *
+     * @param first Iteratore al primo nodo.
+     * @param last Iteratore alla fine della sequenza di nodi.
+     * @pre i nodi della sequenza sono distinti e al più N
+     */
+    template <typename FwdIt>
+    BITS_CONSTEXPR FixedDigraph(FwdIt first, FwdIt last) : _nodes(), _rows(),
+            _nodes_number(0), _edges_number(0), _equal() {
+        for (; first != last; ++first) {
+            addNode(*first);
+        }
+    }
+
+    /**
+     * @brief Ritorna la capacità del grafo.
+     */
+    static BITS_CONSTEXPR unsigned int capacity() {
+        return N;
+    }
+
+    /**
+     * @brief Ritorna il numero di nodi nel grafo.
+     */
+    BITS_CONSTEXPR unsigned int nodesNumber() const {
+        return _nodes_number;
+    }
+
+    /**
+     * @brief Ritorna il numero di archi nel grafo.
+     */
+    BITS_CONSTEXPR unsigned int edgesNumber() const {
+        return _edges_number;
+    }
+
+    /**
+     * @brief Inserimento del nodo nel grafo.
+     *
+     * Il nodo viene inserito privo di archi entranti e uscenti (nodo isolato).
+     * Non avviene alcuna copia: riga e colonna del nuovo nodo sono già nulle.
+     *
+     * @param node Nodo da inserire.
+     * @pre !exists(node)
+     * @pre nodesNumber() < capacity()
+     */
+    BITS_CONSTEXPR void addNode(const T& node) {
+        assert(!exists(node));
+        assert(_nodes_number < N);
+
+        _nodes[_nodes_number++] = node;
+    }
+
+    /**
+     * @brief Eliminazione del nodo dal grafo.
+     *
+     * Il nodo e tutti i relativi archi entranti o uscenti vengono rimossi dal
+     * grafo. Nodi e righe successivi vengono spostati indietro in place e la
+     * colonna del nodo viene tolta da ogni riga.
+     *
+     * @param node Nodo da rimuovere.
+     * @pre exists(node)
+     */
+    BITS_CONSTEXPR void removeNode(const T& node) {
+        assert(exists(node));
+
+        const unsigned int k = nodeIndex(node);
+        const unsigned int n = _nodes_number;
+
+        _edges_number = _edges_number - outDegreeAt(k) - inDegreeAt(k) +
+                        (edgeAt(k, k) ? 1 : 0);
+
+        for (unsigned int i = k; i + 1 < n; ++i) {
+            _nodes[i] = _nodes[i + 1];
+            for (unsigned int w = 0; w < WORDS; ++w) {
+                _rows[i][w] = _rows[i + 1][w];
+            }
+        }
+        _nodes[n - 1] = T();
+        for (unsigned int w = 0; w < WORDS; ++w) {
+            _rows[n - 1][w] = 0;
+        }
+
+        for (unsigned int i = 0; i + 1 < n; ++i) {
+            copyRemovingBit(_rows[i], _rows[i], n, k);
+            for (unsigned int w = bitWords(n - 1); w < WORDS; ++w) {
+                _rows[i][w] = 0;
+            }
+        }
+        --_nodes_number;
+    }
+
+    /**
+     * @brief Aggiunta dell'arco al grafo.
+     *
+     * @param u Nodo sorgente dell'arco da aggiungere.
+     * @param v Nodo destinazione dell'arco da aggiungere.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @pre !hasEdge(u, v)
+     * @post hasEdge(u, v)
+     */
+    BITS_CONSTEXPR void addEdge(const T& u, const T& v) {
+        assert(!hasEdge(u, v));
+
+        flipBit(_rows[nodeIndex(u)], nodeIndex(v));
+        ++_edges_number;
+    }
+
+    /**
+     * @brief Eliminazione dell'arco dal grafo.
+     *
+     * @param u Nodo sorgente dell'arco da rimuovere.
+     * @param v Nodo destinazione dell'arco da rimuovere.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @pre hasEdge(u, v)
+     * @post !hasEdge(u, v)
+     */
+    BITS_CONSTEXPR void removeEdge(const T& u, const T& v) {
+        assert(hasEdge(u, v));
+
+        flipBit(_rows[nodeIndex(u)], nodeIndex(v));
+        --_edges_number;
+    }
+
+    /**
+     * @brief Determina l'esistenza di un nodo nel grafo.
+     *
+     * @param u Nodo da cercare.
+     * @return true se il nodo è presente nel grafo, false altrimenti.
+     */
+    BITS_CONSTEXPR bool exists(const T& u) const {
+        return nodeIndex(u) != _nodes_number;
+    }
+
+    /**
+     * @brief Determina l'esistenza di un arco nel grafo.
+     *
+     * @param u Nodo sorgente dell'arco da cercare.
+     * @param v Nodo destinazione dell'arco da cercare.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @return true se l'arco è presente nel grafo, false altrimenti.
+     */
+    BITS_CONSTEXPR bool hasEdge(const T& u, const T& v) const {
+        assert(exists(u));
+        assert(exists(v));
+
+        return edgeAt(nodeIndex(u), nodeIndex(v));
+    }
+
+    /**
+     * @brief Ritorna il numero di archi uscenti dal nodo.
+     *
+     * @param u Nodo di cui contare gli archi uscenti.
+     * @pre exists(u)
+     * @return Numero di successori di u.
+     */
+    BITS_CONSTEXPR unsigned int outDegree(const T& u) const {
+        assert(exists(u));
+
+        return outDegreeAt(nodeIndex(u));
+    }
+
+    /**
+     * @brief Ritorna il numero di archi entranti nel nodo.
+     *
+     * @param v Nodo di cui contare gli archi entranti.
+     * @pre exists(v)
+     * @return Numero di predecessori di v.
+     */
+    BITS_CONSTEXPR unsigned int inDegree(const T& v) const {
+        assert(exists(v));
+
+        return inDegreeAt(nodeIndex(v));
+    }
+
+    /**
+     * @brief Ritorna il grafo trasposto, con tutti gli archi invertiti.
+     *
+     * La matrice viene trasposta a blocchi di 64x64 bit con transposeBlock;
+     * per N <= 64 è un solo blocco.
+     *
+     * @return FixedDigraph trasposto, con i nodi nello stesso ordine.
+     */
+    BITS_CONSTEXPR FixedDigraph transpose() const {
+        FixedDigraph tmp;
+        bit_word block[BIT_WORD_BITS] = {};
+
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            tmp._nodes[i] = _nodes[i];
+        }
+        tmp._nodes_number = _nodes_number;
+        tmp._edges_number = _edges_number;
+
+        for (unsigned int bi = 0; bi < WORDS; ++bi) {
+            for (unsigned int bj = 0; bj < WORDS; ++bj) {
+                for (unsigned int r = 0; r < BIT_WORD_BITS; ++r) {
+                    const unsigned int i = bi * BIT_WORD_BITS + r;
+                    block[r] = (i < _nodes_number) ? _rows[i][bj] : 0;
+                }
+
+                transposeBlock(block);
+
+                for (unsigned int c = 0; c < BIT_WORD_BITS; ++c) {
+                    const unsigned int j = bj * BIT_WORD_BITS + c;
+                    if (j < _nodes_number) {
+                        tmp._rows[j][bi] = block[c];
+                    }
+                }
+            }
+        }
+        return tmp;
+    }
+
+    /**
+     * @brief Determina se v è raggiungibile da u con un cammino non vuoto.
+     *
+     * Costo O(n * WORDS) operazioni su parole.
+     *
+     * @param u Nodo di partenza.
+     * @param v Nodo di arrivo.
+     * @pre exists(u)
+     * @pre exists(v)
+     * @return true se esiste un cammino di almeno un arco da u a v.
+     */
+    BITS_CONSTEXPR bool reaches(const T& u, const T& v) const {
+        assert(exists(u));
+        assert(exists(v));
+
+        bit_word seen[WORDS] = {};
+        reachableAt(nodeIndex(u), seen);
+        return testBit(seen, nodeIndex(v));
+    }
+
+    /**
+     * @brief Chiusura transitiva del grafo.
+     *
+     * Algoritmo di Warshall sulle righe di bit: per ogni nodo intermedio k,
+     * ogni riga che contiene k viene unita con la riga di k. Costo
+     * O(n^2 * WORDS), per N <= 64 un OR per coppia (i, k).
+     *
+     * @return FixedDigraph con un arco (u, v) per ogni coppia con
+     * reaches(u, v).
+     */
+    BITS_CONSTEXPR FixedDigraph transitiveClosure() const {
+        FixedDigraph tmp(*this);
+
+        for (unsigned int k = 0; k < _nodes_number; ++k) {
+            for (unsigned int i = 0; i < _nodes_number; ++i) {
+                if (tmp.edgeAt(i, k)) {
+                    for (unsigned int w = 0; w < WORDS; ++w) {
+                        tmp._rows[i][w] |= tmp._rows[k][w];
+                    }
+                }
+            }
+        }
+
+        tmp._edges_number = 0;
+        for (unsigned int i = 0; i < _nodes_number; ++i) {
+            tmp._edges_number += tmp.outDegreeAt(i);
+        }
+        return tmp;
+    }
+
+    /**
+     * @brief Ritorna l'iteratore all'inizio della sequenza di nodi
+     */
+    BITS_CONSTEXPR const_iterator begin() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Ritorna l'iteratore alla fine della sequenza di nodi
+     */
+    BITS_CONSTEXPR const_iterator end() const {
+        return _nodes + _nodes_number;
+    }
+
+}; //class FixedDigraph
+
+template <typename T, typename E, unsigned int N>
+const unsigned int FixedDigraph<T,E,N>::WORDS;
+
+/**
+ * @brief Invia il FixedDigraph sullo stream come matrice di adiacenza.
+ *
+ * Stesso formato dell'operator<< di Digraph.
+ *
+ * @param os Stream di output
+ * @param digraph FixedDigraph da inviare
+ * @return Reference allo stream di output
+ */
+template <typename T, typename E, unsigned int N>
+std::ostream& operator<<(std::ostream& os,
+        const FixedDigraph<T,E,N>& digraph) {
+    const unsigned int n = digraph._nodes_number;
+    std::string row(2 * n, '\t');
+
+    for (unsigned int i = 0; i < n; ++i) {
+        os << '\t' << digraph._nodes[i];
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) {
+            row[2 * j + 1] = digraph.edgeAt(i, j) ? '1' : '0';
+        }
+        os << '\n' << digraph._nodes[i];
+        os.write(row.data(), row.size());
+    }
+
+    return os;
+}
+
+#endif //fixed_digraph_h
@@ -2,20 +2,108 @@
 #include <cassert> //assert
 #include <string> //std::string
 #include <ostream> // std::ostream
+#include <sstream> // std::ostringstream
+#include <vector> // std::vector
+#include <cmath> // std::abs std::sqrt
+#include <atomic> // std::atomic
+#include <thread> // std::thread
+#include <chrono> // std::chrono::milliseconds
+#include <system_error> // std::system_error
+#include <cctype> // std::tolower
+#include <functional> // std::hash std::equal_to
 
 #include "digraph.h"
+#include "arena.h"
+#include "fixed_digraph.h"
+#include "mapped.h"
+#include "sudoku/sudoku.h"
+#include "sudoku/dancing_links.h"
+#include "sudoku/batch.h"
+#include "sudoku/lanes.h"
+#include "sudoku/counter.h"
 
 /**
  * @brief Funtore di uguaglianza tra int
  * 
- * Usa l'operatore == tra interi.
+ * Usa l'operatore == tra interi e fornisce l'hash coerente usato
+ * dall'impronta dei grafi.
  */
 struct Int_equal {
-    bool operator()(const int& a, const int& b) const {
+    constexpr bool operator()(const int& a, const int& b) const {
         return a == b;
     }
+
+    std::size_t hash(const int& a) const {
+        return std::hash<int>()(a);
+    }
+};
+
+/**
+ * @brief Funtore di uguaglianza tra stringhe che ignora maiuscole e
+ * minuscole, senza metodo hash.
+ */
+struct Caseless_equal {
+    bool operator()(const std::string& a, const std::string& b) const {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) !=
+                    std::tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Allocatore che conta le allocazioni ancora attive.
+ * 
+ * Usato per verificare che Digraph restituisca tutta la memoria ottenuta
+ * dal proprio allocatore.
+ */
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    static long live; ///< Allocazioni non ancora restituite
+    static long budget; ///< Allocazioni permesse, negativo senza limite
+
+    CountingAllocator() {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        if (CountingAllocator<char>::budget == 0) {
+            throw std::bad_alloc();
+        }
+        if (CountingAllocator<char>::budget > 0) {
+            --CountingAllocator<char>::budget;
+        }
+        ++CountingAllocator<char>::live;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        --CountingAllocator<char>::live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
 };
 
+template <typename T>
+long CountingAllocator<T>::live = 0;
+
+template <typename T>
+long CountingAllocator<T>::budget = -1;
+
 /**
  * @brief Struct custom utilizzata per testare Digraph
  */
@@ -356,25 +444,2228 @@ void constnessTest() {
     //g.swap(tmp);
 }
 
-int main() {
+/**
+ * @brief Test formati di esportazione
+ */
+void exportTest() {
+    Digraph<int, Int_equal> g(testHelperInt());
+    std::ostringstream os;
 
-#ifndef NDEBUG
-    constructorTest();
-    std::cout << "Test costruttori completati con successo." << std::endl;
+    os << g;
+    assert(os.str() ==
+        "\t1\t2\t3\t4\t5\t6"
+        "\n1\t0\t1\t1\t0\t0\t0"
+        "\n2\t0\t0\t0\t1\t0\t0"
+        "\n3\t0\t0\t0\t1\t1\t0"
+        "\n4\t0\t0\t0\t0\t0\t1"
+        "\n5\t0\t0\t0\t0\t1\t1"
+        "\n6\t0\t0\t0\t0\t0\t0");
 
-    assignmentTest();
-    std::cout << "Test assegnamento completati con successo." << std::endl;
+    os.str("");
+    writeEdgeList(os, g);
+    assert(os.str() == "1 2\n1 3\n2 4\n3 4\n3 5\n4 6\n5 5\n5 6\n");
 
-    editTest();
-    std::cout
-        << "Test modifiche al contenuto del Digraph completate con successo."
-        << std::endl;
+    os.str("");
+    writeMatrixMarket(os, g);
+    assert(os.str() ==
+        "%%MatrixMarket matrix coordinate pattern general\n"
+        "6 6 8\n"
+        "1 2\n1 3\n2 4\n3 4\n3 5\n4 6\n5 5\n5 6\n");
 
-    iteratorTest();
-    std::cout << "Test iteratori completati con successo." << std::endl;
-    
-    constnessTest();
-    std::cout << "Test constness completati con successo." << std::endl;
+    Digraph<Person, Person_equal> g2;
+    g2.addNode(Person("Al \"Bo\"", "Shrdlu", 'G'));
+    g2.addNode(Person("Carl", "Thug", 'B'));
+    g2.addEdge(Person("Carl", "Thug", 'B'), Person("Al \"Bo\"", "Shrdlu", 'G'));
+
+    os.str("");
+    writeDot(os, g2);
+    assert(os.str() ==
+        "digraph {\n"
+        "  n0 [label=\"Al \\\"Bo\\\"\"];\n"
+        "  n1 [label=\"Carl\"];\n"
+        "  n1 -> n0;\n"
+        "}\n");
+
+    const Digraph<int, Int_equal> empty;
+    os.str("");
+    os << empty;
+    writeEdgeList(os, empty);
+    assert(os.str().empty());
+}
+
+/**
+ * @brief Test allocatori personalizzati
+ */
+void allocatorTest() {
+    typedef Digraph<int, Int_equal, CountingAllocator<int> > CountingGraph;
+
+    {
+        CountingGraph g1;
+        for (int i = 0; i < 10; ++i) {
+            g1.addNode(i);
+        }
+        g1.addEdge(0, 1);
+        g1.addEdge(9, 0);
+        g1.removeNode(5);
+        assert(CountingAllocator<char>::live > 0);
+
+        CountingGraph g2(g1);
+        CountingGraph g3;
+        g3 = g2;
+        assert(g3.nodesNumber() == 9);
+        assert(g3.edgesNumber() == 2);
+        assert(g3.hasEdge(9, 0));
+    }
+    assert(CountingAllocator<char>::live == 0);
+
+    MonotonicArena arena;
+    {
+        typedef Digraph<Person, Person_equal, ArenaAllocator<Person> >
+            ArenaGraph;
+
+        ArenaGraph g((ArenaAllocator<Person>(arena)));
+        g.addNode(Person("Alice", "Shrdlu", 'G'));
+        g.addNode(Person("Bob", "Etaoin", 'A'));
+        g.addEdge(Person("Alice", "Shrdlu", 'G'), Person("Bob", "Etaoin", 'A'));
+        assert(arena.allocated() > 0);
+        assert(g.get_allocator() == ArenaAllocator<Person>(arena));
+
+        ArenaGraph copy(g);
+        assert(copy.get_allocator() == g.get_allocator());
+        assert(copy.hasEdge(Person("Alice", "Shrdlu", 'G'),
+                            Person("Bob", "Etaoin", 'A')));
+    }
+    arena.release();
+    assert(arena.allocated() == 0);
+
+#if __cplusplus >= 201703L
+    std::pmr::monotonic_buffer_resource resource;
+    PmrDigraph<int, Int_equal> pg{std::pmr::polymorphic_allocator<int>(
+        &resource)};
+    for (int i = 0; i < 10; ++i) {
+        pg.addNode(i);
+    }
+    pg.addEdge(3, 4);
+    assert(pg.get_allocator().resource() == &resource);
+
+    PmrDigraph<int, Int_equal> pcopy;
+    pcopy = pg; // Il memory resource non viene propagato
+    assert(pcopy.get_allocator().resource() != &resource);
+    assert(pcopy.hasEdge(3, 4));
+#endif
+}
+
+/**
+ * @brief Test grafo trasposto e trasposta mantenuta
+ */
+void transposeTest() {
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Digraph<int, Int_equal> g(nodes.begin(), nodes.end());
+    assert(g.nodesNumber() == 150);
+    assert(g.edgesNumber() == 0);
+
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            g.addEdge(i, j);
+        }
+    }
+
+    Digraph<int, Int_equal> t = g.transpose();
+    assert(t.nodesNumber() == g.nodesNumber());
+    assert(t.edgesNumber() == g.edgesNumber());
+    for (int i = 0; i < 150; ++i) {
+        assert(t.outDegree(i) == g.inDegree(i));
+        assert(t.inDegree(i) == g.outDegree(i));
+        for (int j = 0; j < 150; ++j) {
+            assert(t.hasEdge(j, i) == g.hasEdge(i, j));
+        }
+    }
+
+    // La trasposta mantenuta resta coerente dopo ogni modifica
+    Digraph<int, Int_equal> k(g);
+    k.keepTranspose(true);
+    assert(k.keepsTranspose());
+    k.removeNode(64);
+    k.removeNode(0);
+    k.addNode(1000);
+    k.addEdge(1000, 1);
+    k.addEdge(3, 1000);
+    k.removeEdge(1000, 1);
+    k.addEdge(1000, 149);
+
+    Digraph<int, Int_equal> copy(k);
+    assert(copy.keepsTranspose());
+    copy.keepTranspose(false);
+    assert(!copy.keepsTranspose());
+
+    Digraph<int, Int_equal> kt = k.transpose();
+    Digraph<int, Int_equal> ct = copy.transpose();
+    for (Digraph<int, Int_equal>::const_iterator i = k.begin();
+            i != k.end(); ++i) {
+        assert(k.inDegree(*i) == copy.inDegree(*i));
+        for (Digraph<int, Int_equal>::const_iterator j = k.begin();
+                j != k.end(); ++j) {
+            assert(kt.hasEdge(*j, *i) == k.hasEdge(*i, *j));
+            assert(ct.hasEdge(*j, *i) == k.hasEdge(*i, *j));
+        }
+    }
+
+    // La trasposta di un grafo vuoto è vuota
+    Digraph<int, Int_equal> empty;
+    empty.keepTranspose(true);
+    assert(empty.transpose().nodesNumber() == 0);
+    empty.addNode(1);
+    empty.addEdge(1, 1);
+    assert(empty.inDegree(1) == 1);
+}
+
+/**
+ * @brief Test operazioni insiemistiche tra grafi
+ */
+void setOperationsTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 100; ++i) {
+        nodes.push_back(i);
+    }
+    Graph a(nodes.begin(), nodes.end());
+    Graph b(nodes.begin(), nodes.end());
+    for (int i = 0; i < 100; ++i) {
+        a.addEdge(i, (i * 3) % 100);
+        b.addEdge(i, (i * 7) % 100);
+    }
+
+    // Stessi nodi nello stesso ordine
+    Graph u = graphUnion(a, b);
+    Graph x = graphIntersection(a, b);
+    Graph d = graphDifference(a, b);
+    Graph s = symmetricDifference(a, b);
+    assert(u.nodesNumber() == 100 && x.nodesNumber() == 100);
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 100; ++j) {
+            assert(u.hasEdge(i, j) == (a.hasEdge(i, j) || b.hasEdge(i, j)));
+            assert(x.hasEdge(i, j) == (a.hasEdge(i, j) && b.hasEdge(i, j)));
+            assert(d.hasEdge(i, j) == (a.hasEdge(i, j) && !b.hasEdge(i, j)));
+            assert(s.hasEdge(i, j) == (a.hasEdge(i, j) != b.hasEdge(i, j)));
+        }
+    }
+    assert(u.edgesNumber() + x.edgesNumber() ==
+           a.edgesNumber() + b.edgesNumber());
+    assert(s.edgesNumber() == u.edgesNumber() - x.edgesNumber());
+    assert(d.edgesNumber() == a.edgesNumber() - x.edgesNumber());
+
+    // Nodi diversi e in ordine diverso
+    Graph c;
+    for (int i = 150; i >= 50; --i) {
+        c.addNode(i);
+    }
+    for (int i = 50; i <= 150; ++i) {
+        c.addEdge(i, 50 + (i * 3) % 100);
+    }
+
+    u = graphUnion(a, c);
+    x = graphIntersection(a, c);
+    d = graphDifference(a, c);
+    s = symmetricDifference(a, c);
+    assert(u.nodesNumber() == 151);
+    assert(x.nodesNumber() == 50);
+    assert(d.nodesNumber() == 100);
+    assert(s.nodesNumber() == 151);
+    assert(*u.begin() == 0);
+    for (int i = 0; i <= 150; ++i) {
+        for (int j = 0; j <= 150; ++j) {
+            bool in_a = a.exists(i) && a.exists(j) && a.hasEdge(i, j);
+            bool in_c = c.exists(i) && c.exists(j) && c.hasEdge(i, j);
+            assert(u.hasEdge(i, j) == (in_a || in_c));
+            assert(s.hasEdge(i, j) == (in_a != in_c));
+            if (x.exists(i) && x.exists(j)) {
+                assert(x.hasEdge(i, j) == (in_a && in_c));
+            }
+            if (d.exists(i) && d.exists(j)) {
+                assert(d.hasEdge(i, j) == (in_a && !in_c));
+            }
+        }
+    }
+    assert(s.edgesNumber() == u.edgesNumber() - x.edgesNumber());
+
+    // Operazioni con il grafo vuoto
+    Graph empty;
+    assert(graphUnion(empty, a).edgesNumber() == a.edgesNumber());
+    assert(graphIntersection(a, empty).nodesNumber() == 0);
+    assert(graphDifference(a, empty).edgesNumber() == a.edgesNumber());
+}
+
+/**
+ * @brief Predicato che seleziona gli interi multipli di 3
+ */
+struct MultipleOf3 {
+    bool operator()(const int& n) const {
+        return n % 3 == 0;
+    }
+};
+
+/**
+ * @brief Test sottografi indotti
+ */
+void subgraphTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 200; ++i) {
+        nodes.push_back(i);
+    }
+    Graph g(nodes.begin(), nodes.end());
+    for (int i = 0; i < 200; ++i) {
+        g.addEdge(i, (i * 3) % 200);
+        if (!g.hasEdge(i, (i + 65) % 200)) {
+            g.addEdge(i, (i + 65) % 200);
+        }
+    }
+
+    // Sequenza non ordinata e con duplicati
+    std::vector<int> picked;
+    for (int i = 199; i >= 0; i -= 2) {
+        picked.push_back(i);
+    }
+    picked.push_back(5);
+
+    Graph s = g.inducedSubgraph(picked.begin(), picked.end());
+    assert(s.nodesNumber() == 100);
+    int previous = -1;
+    unsigned int edges = 0;
+    for (Graph::const_iterator i = s.begin(); i != s.end(); ++i) {
+        assert(*i % 2 == 1 && *i > previous);
+        previous = *i;
+        for (Graph::const_iterator j = s.begin(); j != s.end(); ++j) {
+            assert(s.hasEdge(*i, *j) == g.hasEdge(*i, *j));
+            edges += s.hasEdge(*i, *j) ? 1 : 0;
+        }
+    }
+    assert(s.edgesNumber() == edges);
+
+    Graph m = g.inducedSubgraphIf(MultipleOf3());
+    assert(m.nodesNumber() == 67);
+    for (int i = 0; i < 200; i += 3) {
+        for (int j = 0; j < 200; j += 3) {
+            assert(m.hasEdge(i, j) == g.hasEdge(i, j));
+        }
+    }
+
+    Graph none = g.inducedSubgraph(picked.begin(), picked.begin());
+    assert(none.nodesNumber() == 0);
+    assert(none.edgesNumber() == 0);
+
+    Graph all = g.inducedSubgraph(nodes.begin(), nodes.end());
+    assert(all.edgesNumber() == g.edgesNumber());
+}
+
+/**
+ * @brief Test statistiche
+ */
+void statsTest() {
+    typedef Digraph<int, Int_equal, std::allocator<int>, DigraphStats>
+        StatsGraph;
+
+    StatsGraph::resetGlobalStats();
+
+    StatsGraph g;
+    for (int i = 0; i < 10; ++i) {
+        g.addNode(i);
+    }
+    g.removeNode(9);
+    DigraphCounters c = g.stats();
+    assert(c.rebuilds == 11);
+    assert(c.comparisons > 0);
+    assert(c.bytes_allocated >= 9 * sizeof(int) + 9 * sizeof(bit_word));
+    assert(c.bytes_copied > 0);
+
+    g.resetStats();
+    c = g.stats();
+    assert(c.rebuilds == 0 && c.comparisons == 0);
+
+    unsigned long long before = g.globalStats().comparisons;
+    g.addEdge(0, 8);
+    assert(g.stats().comparisons >= 9 + 1);
+    assert(StatsGraph::globalStats().comparisons - before ==
+           g.stats().comparisons);
+
+    // La copia condivide la memoria, la fascia modificata viene duplicata
+    StatsGraph copy(g);
+    assert(copy.stats().rebuilds == 0);
+    assert(copy.stats().bytes_copied == 0);
+    copy.addEdge(1, 2);
+    assert(copy.stats().bytes_copied == 9 * sizeof(bit_word));
+    assert(StatsGraph::globalStats().rebuilds == 11);
+
+    // Letture concorrenti dello stesso grafo: nessun confronto perso
+    g.resetStats();
+    const bool edge = g.hasEdge(0, 8);
+    assert(edge);
+    const unsigned long long per_read = g.stats().comparisons;
+    g.resetStats();
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.push_back(std::thread([&g]() {
+            for (int k = 0; k < 1000; ++k) {
+                assert(g.hasEdge(0, 8));
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < readers.size(); ++t) {
+        readers[t].join();
+    }
+    assert(g.stats().comparisons == 4 * 1000 * per_read);
+
+    StatsGraph::resetGlobalStats();
+    assert(StatsGraph::globalStats().bytes_allocated == 0);
+
+    // Con la policy di default le statistiche non vengono raccolte
+    Digraph<int, Int_equal> h(testHelperInt());
+    assert(h.stats().rebuilds == 0);
+    assert(h.stats().comparisons == 0);
+}
+
+/**
+ * @brief Test copy-on-write
+ */
+void copyOnWriteTest() {
+    typedef Digraph<int, Int_equal, std::allocator<int>, DigraphStats>
+        StatsGraph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    StatsGraph g(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            g.addEdge(i, j);
+        }
+    }
+    const unsigned int edges = g.edgesNumber();
+
+    // Le modifiche alla copia non sono visibili nell'originale e viceversa
+    StatsGraph copy(g);
+    StatsGraph assigned;
+    assigned = g;
+    copy.resetStats();
+    copy.addEdge(0, 1);
+    assert(copy.hasEdge(0, 1) && !g.hasEdge(0, 1));
+    assert(copy.stats().bytes_copied == 64 * 3 * sizeof(bit_word));
+    copy.addEdge(1, 3);
+    assert(copy.stats().bytes_copied == 64 * 3 * sizeof(bit_word));
+    copy.addEdge(140, 1);
+    assert(copy.stats().bytes_copied ==
+           (64 * 3 + 22 * 3) * sizeof(bit_word));
+
+    g.removeEdge(149, 3);
+    assert(!g.hasEdge(149, 3) && copy.hasEdge(149, 3));
+    assert(assigned.hasEdge(149, 3) && !assigned.hasEdge(0, 1));
+    assert(assigned.edgesNumber() == edges);
+    assert(copy.edgesNumber() == edges + 3);
+
+    // removeNode e addNode ricostruiscono senza toccare le copie
+    StatsGraph shrunk(copy);
+    shrunk.removeNode(0);
+    shrunk.addNode(1000);
+    assert(copy.exists(0) && !copy.exists(1000));
+    assert(copy.edgesNumber() == edges + 3);
+
+    // Trasposta mantenuta condivisa e aggiornata separatamente
+    Digraph<int, Int_equal> k(nodes.begin(), nodes.end());
+    k.keepTranspose(true);
+    k.addEdge(3, 7);
+    Digraph<int, Int_equal> kc(k);
+    assert(kc.keepsTranspose());
+    kc.addEdge(7, 3);
+    assert(kc.inDegree(3) == 1 && k.inDegree(3) == 0);
+    Digraph<int, Int_equal> kt = k.transpose();
+    assert(!kt.keepsTranspose());
+    assert(kt.hasEdge(7, 3) && !kt.hasEdge(3, 7));
+    kt.addEdge(3, 7);
+    assert(k.inDegree(7) == 1 && k.outDegree(3) == 1);
+
+    // Con allocatori diversi la copia è completa
+    MonotonicArena arena;
+    Digraph<int, Int_equal, ArenaAllocator<int> > a(nodes.begin(),
+        nodes.end(), ArenaAllocator<int>(arena));
+    a.addEdge(5, 6);
+    MonotonicArena other_arena;
+    Digraph<int, Int_equal, ArenaAllocator<int> > b(a,
+        ArenaAllocator<int>(other_arena));
+    assert(other_arena.allocated() > 0);
+    b.removeEdge(5, 6);
+    assert(a.hasEdge(5, 6));
+
+    // Tutta la memoria condivisa viene restituita una sola volta
+    {
+        Digraph<int, Int_equal, CountingAllocator<int> > c(nodes.begin(),
+                                                           nodes.end());
+        c.keepTranspose(true);
+        Digraph<int, Int_equal, CountingAllocator<int> > d(c);
+        d.addEdge(149, 149);
+        c.removeNode(10);
+        Digraph<int, Int_equal, CountingAllocator<int> > e(d);
+        e = c;
+
+        // Copia della fascia della trasposta fallita dopo quella della
+        // matrice: l'arco non viene aggiunto
+        Digraph<int, Int_equal, CountingAllocator<int> > f(c);
+        const unsigned int before = c.edgesNumber();
+        CountingAllocator<char>::budget = 1;
+        try {
+            c.addEdge(0, 1);
+            assert(false);
+        } catch(std::bad_alloc&) {}
+        CountingAllocator<char>::budget = -1;
+        assert(c.edgesNumber() == before && !c.hasEdge(0, 1));
+        assert(c.outDegree(0) == 0 && c.inDegree(1) == 0);
+        assert(c.fingerprint() == f.fingerprint() && c == f);
+        c.addEdge(0, 1);
+        assert(c.inDegree(1) == 1 && !f.hasEdge(0, 1));
+    }
+    assert(CountingAllocator<char>::live == 0);
+}
+
+/**
+ * @brief Rappresentazione testuale completa di un grafo, per i confronti.
+ */
+template <typename G>
+std::string dump(const G& g) {
+    std::ostringstream os;
+    os << g << '\n' << g.edgesNumber();
+    return os.str();
+}
+
+/**
+ * @brief Test journal delle modifiche
+ */
+void journalTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    Graph g = testHelperInt();
+    assert(!g.keepsJournal());
+    g.keepJournal(true);
+    assert(g.keepsJournal());
+    const std::string start = dump(g);
+    const Graph::checkpoint_type cp0 = g.checkpoint();
+    assert(cp0 == 0);
+
+    g.addEdge(6, 1);
+    g.removeEdge(3, 5);
+    g.addNode(7);
+    g.addEdge(7, 3);
+    g.addEdge(5, 7);
+    const Graph::checkpoint_type cp1 = g.checkpoint();
+    const std::string middle = dump(g);
+
+    // Rimozione di un nodo con cappio, archi entranti e uscenti
+    g.removeNode(5);
+    g.removeNode(1);
+    g.addNode(5);
+    g.addEdge(5, 5);
+    const std::string end = dump(g);
+    assert(g.checkpoint() == cp1 + 4);
+
+    g.rollback(cp1);
+    assert(dump(g) == middle);
+    assert(g.hasEdge(5, 5) && g.hasEdge(5, 7) && g.hasEdge(1, 2));
+    g.rollback(cp0);
+    assert(dump(g) == start);
+
+    // redo riapplica le modifiche nello stesso ordine
+    while (g.redo()) {}
+    assert(dump(g) == end);
+    assert(g.checkpoint() == cp1 + 4);
+
+    // Una nuova modifica scarta le modifiche annullate
+    g.rollback(cp1);
+    g.removeEdge(7, 3);
+    assert(!g.redo());
+    g.rollback(cp1);
+    assert(dump(g) == middle);
+
+    // Le copie non ereditano il journal, l'assegnamento lo svuota
+    Graph copy(g);
+    assert(!copy.keepsJournal());
+    g = testHelperInt();
+    assert(g.keepsJournal() && g.checkpoint() == 0);
+    assert(!g.redo());
+
+    // Trasposta mantenuta e più parole per riga
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Graph h(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            h.addEdge(i, j);
+        }
+    }
+    h.keepTranspose(true);
+    h.keepJournal(true);
+    const std::string before = dump(h);
+    const Graph::checkpoint_type cp = h.checkpoint();
+    h.removeNode(64);
+    h.removeNode(0);
+    h.addNode(1000);
+    h.addEdge(1000, 149);
+    h.addEdge(3, 1000);
+    h.removeNode(130);
+    h.rollback(cp);
+    assert(dump(h) == before);
+    for (int i = 0; i < 150; i += 13) {
+        assert(h.inDegree(i) == h.transpose().outDegree(i));
+    }
+    Graph ht = h.transpose();
+    h.keepTranspose(false);
+    assert(dump(h.transpose()) == dump(ht));
+
+    // Tutta la memoria del journal viene restituita
+    {
+        Digraph<int, Int_equal, CountingAllocator<int> > c(nodes.begin(),
+                                                           nodes.end());
+        c.keepJournal(true);
+        c.addEdge(1, 2);
+        c.removeNode(3);
+        c.rollback(0);
+        Digraph<int, Int_equal, CountingAllocator<int> > d;
+        d.keepJournal(true);
+        d.addNode(1);
+        d.swap(c);
+        assert(d.nodesNumber() == 150 && c.nodesNumber() == 1);
+        d.redo();
+        c.keepJournal(false);
+
+        // Allocazione fallita in ogni punto dell'annullamento di un nodo
+        // rimosso, con le fasce condivise da una copia: grafo invariato
+        d.addEdge(5, 149);
+        d.removeNode(5);
+        const std::string removed = dump(d);
+        const Digraph<int, Int_equal, CountingAllocator<int> > shared(d);
+        bool undone = false;
+        for (long budget = 0; !undone; ++budget) {
+            CountingAllocator<char>::budget = budget;
+            try {
+                d.rollback(d.checkpoint() - 1);
+                undone = true;
+            } catch(std::bad_alloc&) {
+                assert(dump(d) == removed && dump(shared) == removed);
+            }
+            CountingAllocator<char>::budget = -1;
+        }
+        assert(d.nodesNumber() == 150 && d.hasEdge(5, 149));
+        assert(dump(shared) == removed);
+
+        // Lo stesso per archi aggiunti e rimossi, annullati e riapplicati,
+        // con la trasposta mantenuta e le fasce condivise
+        d.keepTranspose(true);
+        const Graph::checkpoint_type cp = d.checkpoint();
+        d.addEdge(0, 1);
+        d.removeEdge(5, 149);
+        const std::string edited = dump(d);
+        d.rollback(cp);
+        const std::string restored = dump(d);
+        for (int step = 0; step < 4; ++step) {
+            const Digraph<int, Int_equal, CountingAllocator<int> > copy(d);
+            const std::string from = dump(d);
+            const Graph::checkpoint_type at = d.checkpoint();
+            bool done = false;
+            for (long budget = 0; !done; ++budget) {
+                CountingAllocator<char>::budget = budget;
+                try {
+                    if (step < 2) {
+                        d.redo();
+                    }
+                    else {
+                        d.rollback(at - 1);
+                    }
+                    done = true;
+                } catch(std::bad_alloc&) {
+                    assert(dump(d) == from && d.checkpoint() == at);
+                    assert(d.inDegree(1) == copy.inDegree(1));
+                    assert(d.inDegree(149) == copy.inDegree(149));
+                }
+                CountingAllocator<char>::budget = -1;
+            }
+        }
+        assert(dump(d) == restored && d.checkpoint() == cp);
+        d.redo();
+        d.redo();
+        assert(dump(d) == edited);
+    }
+    assert(CountingAllocator<char>::live == 0);
+}
+
+/**
+ * @brief Test conteggio di triangoli e archi reciproci
+ */
+void cycleCountTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Graph g(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            g.addEdge(i, j);
+        }
+    }
+
+    // Conteggi attesi con una visita esaustiva
+    std::vector<CycleCounts> expected(150);
+    unsigned long long triangles = 0;
+    unsigned long long reciprocal = 0;
+    for (int u = 0; u < 150; ++u) {
+        for (int v = 0; v < 150; ++v) {
+            if (v == u || !g.hasEdge(u, v)) {
+                continue;
+            }
+            if (g.hasEdge(v, u)) {
+                ++expected[u].reciprocal;
+                reciprocal += (u < v) ? 1 : 0;
+            }
+            for (int w = 0; w < 150; ++w) {
+                if (w != u && w != v && g.hasEdge(v, w) && g.hasEdge(w, u)) {
+                    ++expected[u].triangles;
+                    triangles += (u < v && u < w) ? 1 : 0;
+                }
+            }
+        }
+    }
+    assert(triangles > 0 && reciprocal > 0);
+
+    const unsigned int threads[] = {1, 2, 3, 0};
+    for (unsigned int t = 0; t < 4; ++t) {
+        assert(g.countTriangles(threads[t]) == triangles);
+        assert(g.countReciprocalEdges(threads[t]) == reciprocal);
+        const std::vector<CycleCounts> counts =
+            g.cycleParticipation(threads[t]);
+        assert(counts.size() == 150);
+        for (int u = 0; u < 150; ++u) {
+            assert(counts[u].triangles == expected[u].triangles);
+            assert(counts[u].reciprocal == expected[u].reciprocal);
+        }
+    }
+
+    // Con la trasposta mantenuta il risultato non cambia
+    g.keepTranspose(true);
+    assert(g.countTriangles() == triangles);
+    assert(g.countReciprocalEdges(2) == reciprocal);
+
+    // Cappi e grafi piccoli
+    Graph small;
+    for (int i = 0; i < 3; ++i) {
+        small.addNode(i);
+    }
+    small.addEdge(0, 0);
+    small.addEdge(0, 1);
+    small.addEdge(1, 0);
+    assert(small.countTriangles() == 0);
+    assert(small.countReciprocalEdges() == 1);
+    small.addEdge(1, 2);
+    small.addEdge(2, 0);
+    assert(small.countTriangles() == 1);
+    assert(small.cycleParticipation()[2].triangles == 1);
+    assert(small.cycleParticipation()[2].reciprocal == 0);
+    assert(Graph().countTriangles() == 0);
+    assert(Graph().cycleParticipation().empty());
+}
+
+/**
+ * @brief PageRank calcolato con hasEdge, per confronto.
+ */
+std::vector<double> naivePageRank(const Digraph<int, Int_equal>& g, int n,
+        double damping, unsigned int iterations) {
+    std::vector<double> rank(n, 1.0 / n);
+    for (unsigned int it = 0; it < iterations; ++it) {
+        std::vector<double> next(n, (1 - damping) / n);
+        for (int u = 0; u < n; ++u) {
+            const unsigned int degree = g.outDegree(u);
+            for (int v = 0; v < n; ++v) {
+                if (degree == 0) {
+                    next[v] += damping * rank[u] / n;
+                }
+                else if (g.hasEdge(u, v)) {
+                    next[v] += damping * rank[u] / degree;
+                }
+            }
+        }
+        rank = next;
+    }
+    return rank;
+}
+
+/**
+ * @brief Test prodotto matrice-vettore, PageRank e HITS
+ */
+void rankingTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    // Grafo denso (righe di bit, parole sommate con maskedSum) e grafo
+    // sparso con nodi senza successori (righe compresse)
+    std::vector<int> nodes;
+    for (int i = 0; i < 200; ++i) {
+        nodes.push_back(i);
+    }
+    Graph dense(nodes.begin(), nodes.begin() + 150);
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 1 + (i % 3)) {
+            dense.addEdge(i, j);
+        }
+    }
+    Graph sparse(nodes.begin(), nodes.end());
+    for (int i = 0; i < 200; ++i) {
+        if (i % 5 != 0) {
+            sparse.addEdge(i, (i * 3 + 1) % 200);
+        }
+    }
+    sparse.addEdge(7, 7);
+    const Graph* graphs[] = {&dense, &sparse};
+    const int sizes[] = {150, 200};
+
+    for (int k = 0; k < 2; ++k) {
+        const Graph& g = *graphs[k];
+        const int n = sizes[k];
+
+        std::vector<double> x(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = i % 7 - 2.5;
+        }
+        const std::vector<double> succ = g.multiply(x);
+        const std::vector<double> pred = g.multiply(x, true, 3);
+        for (int i = 0; i < n; ++i) {
+            double s = 0;
+            double p = 0;
+            for (int j = 0; j < n; ++j) {
+                s += g.hasEdge(i, j) ? x[j] : 0;
+                p += g.hasEdge(j, i) ? x[j] : 0;
+            }
+            assert(std::abs(succ[i] - s) < 1e-9);
+            assert(std::abs(pred[i] - p) < 1e-9);
+        }
+
+        const std::vector<double> expected = naivePageRank(g, n, 0.85, 30);
+        const std::vector<double> rank = g.pageRank(0.85, 0.0, 30, 2);
+        const std::vector<float> rank_f = g.pageRank(0.85f, 0.0f, 30);
+        double sum = 0;
+        for (int i = 0; i < n; ++i) {
+            assert(std::abs(rank[i] - expected[i]) < 1e-12);
+            assert(std::abs(rank_f[i] - expected[i]) < 1e-5);
+            sum += rank[i];
+        }
+        assert(std::abs(sum - 1) < 1e-9);
+
+        // Convergenza: la soglia ferma l'iterazione vicino al punto fisso
+        const std::vector<double> converged = g.pageRank(0.85, 1e-10, 1000);
+        const std::vector<double> fixed = g.pageRank(0.85, 0.0, 1000);
+        for (int i = 0; i < n; ++i) {
+            assert(std::abs(converged[i] - fixed[i]) < 1e-9);
+        }
+    }
+
+    // Senza smorzamento su un ciclo tutti i nodi hanno lo stesso rank
+    Graph ring(nodes.begin(), nodes.begin() + 4);
+    for (int i = 0; i < 4; ++i) {
+        ring.addEdge(i, (i + 1) % 4);
+    }
+    const std::vector<double> flat = ring.pageRank(1.0);
+    for (int i = 0; i < 4; ++i) {
+        assert(std::abs(flat[i] - 0.25) < 1e-12);
+    }
+
+    // HITS su una stella: il centro è l'unica authority
+    Graph star(nodes.begin(), nodes.begin() + 5);
+    for (int i = 1; i < 5; ++i) {
+        star.addEdge(i, 0);
+    }
+    std::vector<double> hubs;
+    std::vector<double> authorities;
+    star.hitsScores(hubs, authorities);
+    assert(hubs.size() == 5 && authorities.size() == 5);
+    assert(std::abs(authorities[0] - 1) < 1e-9 && hubs[0] == 0);
+    for (int i = 1; i < 5; ++i) {
+        assert(authorities[i] == 0 && std::abs(hubs[i] - 0.5) < 1e-9);
+    }
+
+    // HITS è un punto fisso del prodotto con la matrice e la trasposta
+    std::vector<float> hubs_f;
+    std::vector<float> authorities_f;
+    dense.hitsScores(hubs, authorities, 1e-12, 1000);
+    dense.hitsScores(hubs_f, authorities_f, 1e-6f);
+    std::vector<double> a = dense.multiply(hubs, true);
+    std::vector<double> h = dense.multiply(authorities);
+    double na = 0;
+    double nh = 0;
+    for (int i = 0; i < 150; ++i) {
+        na += a[i] * a[i];
+        nh += h[i] * h[i];
+    }
+    for (int i = 0; i < 150; ++i) {
+        assert(std::abs(a[i] / std::sqrt(na) - authorities[i]) < 1e-9);
+        assert(std::abs(h[i] / std::sqrt(nh) - hubs[i]) < 1e-9);
+        assert(std::abs(authorities_f[i] - authorities[i]) < 1e-4);
+    }
+
+    // Gli stessi thread per tutte le iterazioni danno lo stesso risultato
+    // del calcolo senza thread
+    std::vector<double> hubs_1, authorities_1;
+    sparse.hitsScores(hubs, authorities, 0.0, 50, 4);
+    sparse.hitsScores(hubs_1, authorities_1, 0.0, 50, 1);
+    assert(hubs == hubs_1 && authorities == authorities_1);
+    assert(sparse.pageRank(0.85, 0.0, 50, 4) ==
+           sparse.pageRank(0.85, 0.0, 50, 1));
+
+    assert(Graph().pageRank().empty());
+    Graph().hitsScores(hubs, authorities);
+    assert(hubs.empty() && authorities.empty());
+}
+
+/**
+ * @brief Test uguaglianza e impronta strutturale
+ */
+void equalityTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Graph g(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            g.addEdge(i, j);
+        }
+    }
+
+    // Copia condivisa, fasce private dopo una modifica, ripristino
+    Graph copy(g);
+    assert(copy == g && !(copy != g));
+    assert(copy.fingerprint() == g.fingerprint());
+    copy.addEdge(149, 2);
+    assert(copy != g && copy.fingerprint() != g.fingerprint());
+    copy.removeEdge(149, 2);
+    assert(copy == g && copy.fingerprint() == g.fingerprint());
+
+    // Stessi nodi e archi in ordine diverso, costruiti in modo diverso
+    Graph reversed(nodes.rbegin(), nodes.rend());
+    for (int i = 149; i >= 0; --i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            reversed.addEdge(i, j);
+        }
+    }
+    assert(reversed == g && g == reversed);
+    assert(reversed.fingerprint() == g.fingerprint());
+    reversed.removeEdge(0, 3);
+    reversed.addEdge(0, 4);
+    assert(reversed != g);
+
+    // Impronta aggiornata da ogni modifica e dalle ricostruzioni
+    Graph edited(g);
+    edited.keepJournal(true);
+    edited.addNode(1000);
+    edited.addEdge(1000, 1000);
+    edited.addEdge(1000, 7);
+    edited.addEdge(7, 1000);
+    edited.removeNode(64);
+    edited.removeEdge(1, 2);
+    Graph rebuilt(edited.begin(), edited.end());
+    for (Graph::const_iterator u = edited.begin(); u != edited.end(); ++u) {
+        for (Graph::const_iterator v = edited.begin(); v != edited.end();
+                ++v) {
+            if (edited.hasEdge(*u, *v)) {
+                rebuilt.addEdge(*u, *v);
+            }
+        }
+    }
+    assert(rebuilt == edited && rebuilt.fingerprint() == edited.fingerprint());
+    edited.rollback(0);
+    assert(edited == g && edited.fingerprint() == g.fingerprint());
+    assert(edited.transpose().transpose() == g);
+    assert(edited.transpose().fingerprint() ==
+           g.transpose().transpose().transpose().fingerprint());
+    edited.keepTranspose(true);
+    assert(edited.transpose().transpose().fingerprint() == g.fingerprint());
+    assert(graphUnion(g, g) == g && graphIntersection(g, reversed) != g);
+    assert(graphUnion(g, g).fingerprint() == g.fingerprint());
+    assert(g.inducedSubgraph(nodes.begin(), nodes.end()) == g);
+    assert(graphDifference(g, g) == Graph(nodes.begin(), nodes.end()));
+
+    // Stessi nodi e gradi ma archi diversi: impronte diverse
+    const int four[] = {0, 1, 2, 3};
+    Graph crossed(four, four + 4), swapped(four, four + 4);
+    crossed.addEdge(0, 1);
+    crossed.addEdge(2, 3);
+    swapped.addEdge(0, 2);
+    swapped.addEdge(3, 1);
+    assert(crossed != swapped);
+    assert(crossed.fingerprint() != swapped.fingerprint());
+    swapped.removeEdge(0, 2);
+    swapped.removeEdge(3, 1);
+    swapped.addEdge(2, 3);
+    swapped.addEdge(0, 1);
+    assert(crossed == swapped);
+    assert(crossed.fingerprint() == swapped.fingerprint());
+
+    // Nodi diversi con la stessa struttura: impronte diverse
+    Graph shifted;
+    for (int i = 1; i <= 6; ++i) {
+        shifted.addNode(i + 10);
+    }
+    const Graph small = testHelperInt();
+    shifted.addEdge(11, 12);
+    shifted.addEdge(11, 13);
+    shifted.addEdge(12, 14);
+    shifted.addEdge(13, 14);
+    shifted.addEdge(13, 15);
+    shifted.addEdge(14, 16);
+    shifted.addEdge(15, 15);
+    shifted.addEdge(15, 16);
+    assert(shifted.fingerprint() != small.fingerprint());
+    assert(shifted != small);
+    assert(Graph() == Graph() && Graph() != small);
+
+    // Nodi uguali per E ma con std::hash diverso: E senza hash, impronta
+    // calcolata solo dalla struttura
+    const std::string upper[] = {"Alfa", "Beta"}, lower[] = {"alfa", "beta"};
+    Digraph<std::string, Caseless_equal> named(upper, upper + 2);
+    Digraph<std::string, Caseless_equal> renamed(lower, lower + 2);
+    named.addEdge("Alfa", "Beta");
+    renamed.addEdge("beta", "ALFA");
+    assert(named != renamed);
+    renamed.removeEdge("BETA", "alfa");
+    renamed.addEdge("alfa", "beta");
+    assert(named.fingerprint() == renamed.fingerprint());
+    assert(named == renamed);
+
+    // Con std::equal_to viene usato std::hash
+    Digraph<int, std::equal_to<int> > standard(four, four + 4);
+    Digraph<int, std::equal_to<int> > other_standard(four, four + 4);
+    standard.addEdge(0, 1);
+    other_standard.addEdge(2, 3);
+    assert(standard.fingerprint() != other_standard.fingerprint());
+
+    const Digraph<Person, Person_equal> people = testHelperPerson();
+    Digraph<Person, Person_equal> other_people(people);
+    assert(people == other_people);
+    other_people.removeNode(Person("Bob", "Etaoin", 'A'));
+    assert(people != other_people);
+}
+
+/**
+ * @brief Test albero dei dominatori
+ */
+void dominatorTest() {
+    typedef Digraph<int, Int_equal> Graph;
+
+    // Grafo sparso con cicli, cappi e nodi non raggiungibili
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Graph g(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        if (i % 11 != 10) {
+            g.addEdge(i, (i * 3 + 1) % 150);
+        }
+        if (i % 4 == 0) {
+            g.addEdge(i, (i + 7) % 150);
+        }
+        if (i % 9 == 0) {
+            g.addEdge(i, i);
+        }
+    }
+
+    // Dominatori attesi: a domina b se togliendo a b non è raggiungibile
+    std::vector<std::vector<int> > succ(150);
+    for (int u = 0; u < 150; ++u) {
+        for (int v = 0; v < 150; ++v) {
+            if (g.hasEdge(u, v)) {
+                succ[u].push_back(v);
+            }
+        }
+    }
+    const int roots[] = {0, 1, 64};
+    for (int k = 0; k < 3; ++k) {
+        const int root = roots[k];
+        const DominatorTree tree = g.dominatorTree(root);
+        assert(tree.size() == 150 && tree.root() == unsigned(root));
+        assert(tree.immediateDominator(root) == DominatorTree::NONE);
+
+        for (int a = -1; a < 150; ++a) {
+            std::vector<bool> seen(150, false);
+            std::vector<int> stack;
+            if (a != root) {
+                seen[root] = true;
+                stack.push_back(root);
+            }
+            while (!stack.empty()) {
+                const int u = stack.back();
+                stack.pop_back();
+                for (std::size_t e = 0; e < succ[u].size(); ++e) {
+                    const int v = succ[u][e];
+                    if (v != a && !seen[v]) {
+                        seen[v] = true;
+                        stack.push_back(v);
+                    }
+                }
+            }
+            if (a == -1) {
+                for (int b = 0; b < 150; ++b) {
+                    assert(tree.reachable(b) == seen[b]);
+                }
+                continue;
+            }
+            for (int b = 0; b < 150; ++b) {
+                const bool expected = tree.reachable(a) &&
+                                      tree.reachable(b) &&
+                                      (a == b || !seen[b]);
+                assert(tree.dominates(a, b) == expected);
+            }
+        }
+
+        // Il dominatore immediato è il dominatore stretto più vicino
+        for (int b = 0; b < 150; ++b) {
+            const unsigned int d = tree.immediateDominator(b);
+            if (b == root || !tree.reachable(b)) {
+                assert(d == DominatorTree::NONE);
+                continue;
+            }
+            assert(d != unsigned(b) && tree.dominates(d, b));
+            for (int a = 0; a < 150; ++a) {
+                if (a != b && tree.dominates(a, b)) {
+                    assert(tree.dominates(a, d));
+                }
+            }
+        }
+    }
+
+    // Esempio con due rami che si ricongiungono e un ciclo
+    Graph cfg(nodes.begin(), nodes.begin() + 6);
+    cfg.addEdge(0, 1);
+    cfg.addEdge(1, 2);
+    cfg.addEdge(1, 3);
+    cfg.addEdge(2, 4);
+    cfg.addEdge(3, 4);
+    cfg.addEdge(4, 1);
+    cfg.addEdge(4, 5);
+    const DominatorTree t = cfg.dominatorTree(0);
+    const unsigned int expected[] = {DominatorTree::NONE, 0, 1, 1, 1, 4};
+    assert(t.immediateDominators() ==
+           std::vector<unsigned int>(expected, expected + 6));
+    assert(t.dominates(1, 5) && !t.dominates(2, 4) && !t.dominates(5, 4));
+
+    // Un solo nodo: la radice domina se stessa
+    Graph single;
+    single.addNode(42);
+    assert(single.dominatorTree(42).dominates(0, 0));
+}
+
+/**
+ * @brief Test grafo su file mappato in memoria
+ */
+void mappedTest() {
+#ifdef MAPPED_ARENA_AVAILABLE
+    typedef Digraph<int, Int_equal, MappedAllocator<int> > MappedGraph;
+
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Digraph<int, Int_equal> expected(nodes.begin(), nodes.end());
+
+    MappedArena arena(".", 1 << 20);
+    assert(arena.capacity() >= (1 << 20) && arena.allocated() == 0);
+    {
+        MappedGraph g(nodes.begin(), nodes.end(),
+                      MappedAllocator<int>(arena));
+        assert(arena.allocated() > 150 * 3 * sizeof(bit_word));
+        for (int i = 0; i < 150; ++i) {
+            for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+                g.addEdge(i, j);
+                expected.addEdge(i, j);
+            }
+        }
+        assert(dump(g) == dump(expected));
+
+        // I consigli di accesso non cambiano il contenuto
+        g.keepTranspose(true);
+        g.sequentialScan(true);
+        for (int i = 0; i < 150; ++i) {
+            g.prefetch(i);
+            assert(g.outDegree(i) == expected.outDegree(i));
+            assert(g.inDegree(i) == expected.inDegree(i));
+        }
+        g.sequentialScan(false);
+
+        // Le pagine scaricate sul file vengono rilette uguali
+        arena.evict();
+        assert(dump(g) == dump(expected));
+        g.removeNode(64);
+        expected.removeNode(64);
+        assert(dump(g) == dump(expected));
+    }
+
+    // Capacità esaurita
+    // Capacità esaurita, in una seconda arena nella stessa directory
+    MappedArena small(".", 1);
+    bool thrown = false;
+    try {
+        MappedGraph g(nodes.begin(), nodes.end(),
+                      MappedAllocator<int>(small));
+        g.keepTranspose(true);
+        for (int i = 150; i < 10000; ++i) {
+            g.addNode(i);
+        }
+    } catch(std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Directory inesistente
+    thrown = false;
+    try {
+        MappedArena missing("mapped_missing_dir", 1);
+    } catch(std::system_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Con gli altri allocatori i consigli non fanno nulla
+    expected.prefetch(3);
+    expected.sequentialScan(true);
+    assert(dump(expected) == dump(expected.transpose().transpose()));
+#endif
+}
+
+#if __cplusplus >= 201402L
+/**
+ * @brief Cammino 0 -> 1 -> 2 -> 3 costruito a tempo di compilazione.
+ */
+constexpr FixedDigraph<int, Int_equal, 8> fixedChain() {
+    FixedDigraph<int, Int_equal, 8> g;
+    for (int i = 0; i < 4; ++i) {
+        g.addNode(i);
+    }
+    for (int i = 0; i < 3; ++i) {
+        g.addEdge(i, i + 1);
+    }
+    return g;
+}
+
+static_assert(fixedChain().edgesNumber() == 3, "fixedChain");
+static_assert(fixedChain().reaches(0, 3) && !fixedChain().reaches(3, 0),
+              "fixedChain reaches");
+static_assert(fixedChain().transitiveClosure().edgesNumber() == 6,
+              "fixedChain transitiveClosure");
+#endif
+
+/**
+ * @brief Test FixedDigraph
+ */
+void fixedDigraphTest() {
+    // Stesso grafo della traccia, confrontato con Digraph
+    Digraph<int, Int_equal> g = testHelperInt();
+    FixedDigraph<int, Int_equal, 8> f(g.begin(), g.end());
+    for (Digraph<int, Int_equal>::const_iterator i = g.begin();
+            i != g.end(); ++i) {
+        for (Digraph<int, Int_equal>::const_iterator j = g.begin();
+                j != g.end(); ++j) {
+            if (g.hasEdge(*i, *j)) {
+                f.addEdge(*i, *j);
+            }
+        }
+    }
+    assert(f.nodesNumber() == 6);
+    assert(f.edgesNumber() == g.edgesNumber());
+    assert(f.capacity() == 8);
+
+    std::ostringstream gs, fs;
+    gs << g;
+    fs << f;
+    assert(gs.str() == fs.str());
+
+    assert(f.reaches(1, 6));
+    assert(f.reaches(5, 5));
+    assert(!f.reaches(1, 1));
+    assert(!f.reaches(6, 1));
+
+    FixedDigraph<int, Int_equal, 8> c = f.transitiveClosure();
+    for (int i = 1; i <= 6; ++i) {
+        for (int j = 1; j <= 6; ++j) {
+            assert(c.hasEdge(i, j) == f.reaches(i, j));
+        }
+    }
+
+    f.removeNode(4);
+    g.removeNode(4);
+    assert(f.edgesNumber() == g.edgesNumber());
+    assert(!f.reaches(2, 6));
+    f.addNode(4);
+    assert(f.outDegree(4) == 0 && f.inDegree(4) == 0);
+
+    // Più parole per riga, confrontato con Digraph dopo modifiche
+    std::vector<int> nodes;
+    for (int i = 0; i < 150; ++i) {
+        nodes.push_back(i);
+    }
+    Digraph<int, Int_equal> h(nodes.begin(), nodes.end());
+    FixedDigraph<int, Int_equal, 150> k(nodes.begin(), nodes.end());
+    for (int i = 0; i < 150; ++i) {
+        for (int j = (i * 7) % 5; j < 150; j += 3 + (i % 4)) {
+            h.addEdge(i, j);
+            k.addEdge(i, j);
+        }
+    }
+    h.removeNode(64);
+    k.removeNode(64);
+    h.removeNode(0);
+    k.removeNode(0);
+    h.addNode(1000);
+    k.addNode(1000);
+    h.addEdge(1000, 149);
+    k.addEdge(1000, 149);
+
+    FixedDigraph<int, Int_equal, 150> kt = k.transpose();
+    assert(k.edgesNumber() == h.edgesNumber());
+    assert(kt.edgesNumber() == h.edgesNumber());
+    for (FixedDigraph<int, Int_equal, 150>::const_iterator i = k.begin();
+            i != k.end(); ++i) {
+        assert(k.outDegree(*i) == h.outDegree(*i));
+        assert(k.inDegree(*i) == h.inDegree(*i));
+        for (FixedDigraph<int, Int_equal, 150>::const_iterator j = k.begin();
+                j != k.end(); ++j) {
+            assert(k.hasEdge(*i, *j) == h.hasEdge(*i, *j));
+            assert(kt.hasEdge(*j, *i) == h.hasEdge(*i, *j));
+        }
+    }
+
+    FixedDigraph<int, Int_equal, 150> kc = k.transitiveClosure();
+    for (int i = 140; i < 150; ++i) {
+        for (int j = 1; j < 150; j += 7) {
+            if (j != 64) {
+                assert(kc.hasEdge(i, j) == k.reaches(i, j));
+            }
+        }
+    }
+    assert(kc.hasEdge(1000, 149) && !kc.hasEdge(1, 1000));
+}
+
+/**
+ * @brief Controlla che solved sia una soluzione di puzzle.
+ *
+ * solved deve essere completo e valido e conservare le celle piene di
+ * puzzle.
+ */
+template <int B>
+bool isSolutionOf(const BasicSudoku<B>& solved,
+        const BasicSudoku<B>& puzzle) {
+    if (!solved.complete() || !solved.valid()) {
+        return false;
+    }
+    for (int i = 0; i < BasicSudoku<B>::SIZE; ++i) {
+        for (int j = 0; j < BasicSudoku<B>::SIZE; ++j) {
+            if (puzzle.get(i, j) != 0 &&
+                    puzzle.get(i, j) != solved.get(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Test Sudoku
+ */
+void sudokuTest() {
+    const std::string puzzle =
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..";
+    const std::string solution =
+        "812753649943682175675491283154237896369845721287169534"
+        "521974368438526917796318452";
+
+    // Lettura e scrittura nel formato a 81 caratteri
+    Sudoku s;
+    assert(s.str() == std::string(81, '.'));
+    assert(s.valid() && !s.complete());
+    assert(s.read(puzzle + " \r"));
+    assert(s.str() == puzzle);
+    assert(s.get(0, 0) == 8 && s.get(0, 1) == 0 && s.get(8, 6) == 4);
+    assert(!s.read(puzzle.substr(1)));
+    assert(!s.read(puzzle + "1"));
+    assert(!s.read("x" + puzzle.substr(1)));
+    assert(s.str() == puzzle);
+    Sudoku zeros;
+    std::string with_zeros(puzzle);
+    for (std::string::size_type k = 0; k < with_zeros.size(); ++k) {
+        if (with_zeros[k] == '.') {
+            with_zeros[k] = '0';
+        }
+    }
+    assert(zeros.read(with_zeros) && zeros.str() == puzzle);
+
+    // Soluzione e mosse
+    const Sudoku original(s);
+    assert(s.solve());
+    assert(s.str() == solution);
+    assert(isSolutionOf(s, original));
+    assert(s.nodes() > 0);
+
+    // Le mosse, dalla più recente alla prima, riempiono le celle vuote
+    const std::vector<Sudoku::Move>& moves = s.moves();
+    assert(moves.size() == 81 - 21);
+    Sudoku replay(original);
+    for (std::vector<Sudoku::Move>::const_reverse_iterator i = moves.rbegin();
+            i != moves.rend(); ++i) {
+        assert(replay.get(i->row, i->column) == 0);
+        replay.set(i->row, i->column, i->value);
+    }
+    assert(replay.str() == solution);
+
+    // Griglia da costruttore, come nell'applicazione Qt
+    short grid[Sudoku::SIZE][Sudoku::SIZE];
+    for (int i = 0; i < Sudoku::SIZE; ++i) {
+        for (int j = 0; j < Sudoku::SIZE; ++j) {
+            grid[i][j] = original.get(i, j);
+        }
+    }
+    Sudoku from_grid(grid);
+    assert(from_grid.str() == puzzle);
+
+    // Griglia non valida: due 8 nella prima riga
+    Sudoku invalid(original);
+    invalid.set(0, 5, 8);
+    assert(!invalid.valid());
+    assert(!invalid.solve());
+    assert(invalid.moves().empty());
+    invalid.set(0, 5, 0);
+    invalid.set(4, 0, 8);
+    assert(!invalid.valid());
+    invalid.set(4, 0, 0);
+    invalid.set(2, 2, 8);
+    assert(!invalid.valid());
+    invalid.set(2, 2, 0);
+    assert(invalid.valid());
+
+    // Le maschere vengono ricalcolate a ogni solve
+    assert(invalid.solve() && invalid.str() == solution);
+    assert(invalid.solve() && invalid.moves().empty());
+    invalid.set(0, 1, 0);
+    invalid.set(8, 8, 0);
+    assert(invalid.solve() && invalid.str() == solution);
+    assert(invalid.moves().size() == 2);
+
+    // Griglia valida senza soluzione: la cella (0, 8) non ha valori
+    Sudoku impossible;
+    for (short j = 0; j < 8; ++j) {
+        impossible.set(0, j, j + 1);
+    }
+    impossible.set(4, 8, 9);
+    assert(impossible.valid());
+    const std::string before = impossible.str();
+    assert(!impossible.solve());
+    assert(impossible.str() == before);
+    assert(impossible.moves().empty());
+    impossible.set(4, 8, 0);
+    assert(impossible.solve() && impossible.get(0, 8) == 9);
+
+    // La cella (8, 8) non ha candidati: la ricerca si ferma al primo nodo
+    // anche se la cella è l'ultima in ordine di riga
+    Sudoku dead_end;
+    for (short j = 0; j < 8; ++j) {
+        dead_end.set(8, j, j + 1);
+    }
+    dead_end.set(0, 8, 9);
+    assert(dead_end.valid());
+    assert(!dead_end.solve());
+    assert(dead_end.nodes() == 1);
+
+    // Sudoku contro la ricerca in ordine di riga: la prima riga è vuota e
+    // la soluzione la riempie con 987654321; con la cella con meno
+    // candidati bastano pochi nodi
+    Sudoku adversarial;
+    assert(adversarial.read(
+        "..............3.85..1.2.......5.7.....4...1...9.......5......"
+        "73..2.1........4...9"));
+    const Sudoku adversarial_puzzle(adversarial);
+    assert(adversarial.solve());
+    assert(isSolutionOf(adversarial, adversarial_puzzle));
+    assert(adversarial.str().substr(0, 9) == "987654321");
+    assert(adversarial.nodes() < 100000);
+
+    // Stessa soluzione con ogni propagazione; senza propagazione tutte le
+    // mosse sono scelte della ricerca
+    const Sudoku::Propagation levels[] = {
+        Sudoku::NO_PROPAGATION, Sudoku::SINGLES, Sudoku::LOCKED_CANDIDATES
+    };
+    for (int l = 0; l < 3; ++l) {
+        Sudoku level(original);
+        level.setPropagation(levels[l]);
+        assert(level.propagation() == levels[l]);
+        assert(level.solve() && level.str() == solution);
+        Sudoku level_replay(original);
+        int guesses = 0;
+        for (std::vector<Sudoku::Move>::const_reverse_iterator i =
+                level.moves().rbegin(); i != level.moves().rend(); ++i) {
+            assert(level_replay.get(i->row, i->column) == 0);
+            level_replay.set(i->row, i->column, i->value);
+            guesses += i->kind == Sudoku::GUESS;
+        }
+        assert(level_replay.str() == solution);
+        assert(level.moves().size() == 81 - 21);
+        assert(levels[l] != Sudoku::NO_PROPAGATION ||
+               guesses == 81 - 21);
+        assert(levels[l] == Sudoku::NO_PROPAGATION ||
+               guesses < 81 - 21);
+    }
+
+    // Solo propagazione: le celle dedotte coincidono con la soluzione e le
+    // mosse sono tutte deduzioni
+    const std::string locked_puzzle =
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5"
+        "..2.....1.4......";
+    const std::string locked_solution =
+        "417369825632158947958724316825437169791586432346912758289643571"
+        "573291684164875293";
+    Sudoku deduced;
+    deduced.setPropagation(Sudoku::NO_PROPAGATION);
+    assert(deduced.read(locked_puzzle));
+    assert(deduced.deduce());
+    assert(deduced.str() == locked_puzzle && deduced.moves().empty());
+
+    deduced.setPropagation(Sudoku::SINGLES);
+    assert(deduced.deduce() && !deduced.complete());
+    assert(deduced.nodes() == 0 && !deduced.moves().empty());
+    int filled = 0;
+    for (int k = 0; k < 81; ++k) {
+        const short value = deduced.get(k / 9, k % 9);
+        if (value != 0) {
+            ++filled;
+            assert(value == locked_solution[k] - '0');
+        }
+    }
+    assert(deduced.moves().size() == filled - 17u);
+    for (std::vector<Sudoku::Move>::const_iterator i =
+            deduced.moves().begin(); i != deduced.moves().end(); ++i) {
+        assert(i->kind != Sudoku::GUESS);
+        assert(locked_puzzle[i->row * 9 + i->column] == '.');
+    }
+
+    // I candidati bloccati bastano a completare lo stesso Sudoku
+    assert(deduced.read(locked_puzzle));
+    deduced.setPropagation(Sudoku::LOCKED_CANDIDATES);
+    assert(deduced.deduce() && deduced.str() == locked_solution);
+    assert(deduced.moves().size() == 81 - 17u);
+    bool naked = false, hidden = false;
+    for (std::vector<Sudoku::Move>::const_iterator i =
+            deduced.moves().begin(); i != deduced.moves().end(); ++i) {
+        assert(i->kind != Sudoku::GUESS);
+        naked |= i->kind == Sudoku::NAKED_SINGLE;
+        hidden |= i->kind == Sudoku::HIDDEN_SINGLE;
+    }
+    assert(naked && hidden);
+
+    // Le deduzioni scoprono la contraddizione: la griglia resta invariata.
+    // (0, 7) e (0, 8) ammettono solo il 9
+    Sudoku contradiction;
+    for (short j = 0; j < 7; ++j) {
+        contradiction.set(0, j, j + 1);
+    }
+    contradiction.set(3, 7, 8);
+    contradiction.set(6, 8, 8);
+    assert(contradiction.valid());
+    const std::string contradiction_grid = contradiction.str();
+    assert(!contradiction.deduce());
+    assert(contradiction.str() == contradiction_grid);
+    assert(contradiction.moves().empty());
+    contradiction.setPropagation(Sudoku::NO_PROPAGATION);
+    assert(contradiction.deduce());
+    assert(!contradiction.solve());
+    assert(contradiction.str() == contradiction_grid);
+
+    // Griglia vuota e griglia già completa
+    Sudoku empty;
+    assert(empty.solve() && empty.complete() && empty.valid());
+    assert(empty.moves().size() == 81);
+    Sudoku full;
+    assert(full.read(solution));
+    assert(full.solve() && full.moves().empty() && full.nodes() == 1);
+
+    full.clear();
+    assert(full.str() == std::string(81, '.'));
+}
+
+/**
+ * @brief SudokuMonitor che registra le chiamate e ferma la ricerca dopo
+ * limit chiamate.
+ */
+class CountingMonitor : public SudokuMonitor {
+public:
+    unsigned long calls;
+    unsigned long limit;
+    unsigned long long last_nodes;
+    int max_depth;
+
+    explicit CountingMonitor(unsigned long l) : calls(0), limit(l),
+            last_nodes(0), max_depth(0) {}
+
+    bool progress(unsigned long long nodes, int depth) {
+        assert(nodes > last_nodes);
+        assert(depth >= 0 && depth <= Sudoku::CELLS);
+        ++calls;
+        last_nodes = nodes;
+        max_depth = std::max(max_depth, depth);
+        return calls < limit;
+    }
+};
+
+/**
+ * @brief Test SudokuMonitor
+ */
+void monitorTest() {
+    // Sudoku senza propagazione che richiede migliaia di nodi
+    Sudoku puzzle;
+    assert(puzzle.read(
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4.."));
+    puzzle.setPropagation(Sudoku::NO_PROPAGATION);
+    Sudoku expected(puzzle);
+    assert(expected.solve());
+    assert(expected.nodes() > 1000);
+
+    // Un monitor che non ferma la ricerca non cambia la soluzione
+    Sudoku s(puzzle);
+    CountingMonitor all(~0ul);
+    assert(s.solve(all, 100));
+    assert(!s.interrupted());
+    assert(s.str() == expected.str() && s.nodes() == expected.nodes());
+    assert(s.moves().size() == expected.moves().size());
+    assert(all.calls == expected.nodes() / 100);
+    assert(all.max_depth > 0);
+
+    // Fermata alla terza chiamata: griglia invariata, nessuna mossa
+    Sudoku stopped(puzzle);
+    CountingMonitor three(3);
+    assert(!stopped.solve(three, 100));
+    assert(stopped.interrupted());
+    assert(three.calls == 3 && stopped.nodes() == 300);
+    assert(stopped.str() == puzzle.str());
+    assert(stopped.moves().empty());
+
+    // Una nuova ricerca, anche senza monitor, riparte da capo
+    assert(stopped.solve() && !stopped.interrupted());
+    assert(stopped.str() == expected.str());
+
+    // Un Sudoku senza soluzione non è interrotto
+    Sudoku impossible;
+    for (short j = 0; j < 8; ++j) {
+        impossible.set(0, j, j + 1);
+    }
+    impossible.set(4, 8, 9);
+    CountingMonitor every(~0ul);
+    assert(!impossible.solve(every, 1));
+    assert(!impossible.interrupted());
+}
+
+/**
+ * @brief Riapplica a puzzle le mosse di solver, dalla prima alla più
+ * recente, controllando che ognuna riempia una cella vuota.
+ */
+Sudoku replayMoves(const Sudoku& puzzle, const SudokuSolver& solver) {
+    Sudoku replay(puzzle);
+    const std::vector<Sudoku::Move>& moves = solver.moves();
+    for (std::vector<Sudoku::Move>::const_reverse_iterator i = moves.rbegin();
+            i != moves.rend(); ++i) {
+        assert(replay.get(i->row, i->column) == 0);
+        replay.set(i->row, i->column, i->value);
+    }
+    return replay;
+}
+
+/**
+ * @brief Test DancingLinksSolver e BacktrackingSolver
+ */
+void dancingLinksTest() {
+    const char* puzzles[] = {
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..",
+        "4.....8.5.3..........7......2.....6.....8.4......1......."
+        "6.3.7.5..2.....1.4......",
+        "..............3.85..1.2.......5.7.....4...1...9.......5."
+        ".....73..2.1........4...9"
+    };
+
+    // Un solo solver per tutti i Sudoku: la matrice torna com'era dopo
+    // ogni ricerca
+    DancingLinksSolver dlx;
+    BacktrackingSolver backtracking;
+    for (int p = 0; p < 3; ++p) {
+        Sudoku puzzle;
+        assert(puzzle.read(puzzles[p]));
+
+        Sudoku expected(puzzle);
+        assert(expected.solve());
+        Sudoku same(puzzle);
+        assert(backtracking.solve(same));
+        assert(same.str() == expected.str());
+        assert(backtracking.moves().size() == expected.moves().size());
+        assert(backtracking.nodes() == expected.nodes());
+
+        Sudoku s(puzzle);
+        assert(dlx.solve(s));
+        assert(isSolutionOf(s, puzzle));
+        assert(s.str() == expected.str());
+        assert(dlx.nodes() > 0 && dlx.seconds() >= 0);
+        assert(replayMoves(puzzle, dlx).str() == expected.str());
+
+        // Le colonne con una sola riga sono singoli
+        int guesses = 0;
+        for (std::vector<Sudoku::Move>::size_type i = 0;
+                i < dlx.moves().size(); ++i) {
+            if (dlx.moves()[i].kind == Sudoku::GUESS) {
+                ++guesses;
+            }
+        }
+        assert(guesses < int(dlx.moves().size()));
+    }
+
+    // Griglia non valida: due 8 nella prima riga
+    Sudoku invalid;
+    assert(invalid.read(puzzles[0]));
+    invalid.set(0, 5, 8);
+    const std::string invalid_grid = invalid.str();
+    assert(!dlx.solve(invalid));
+    assert(invalid.str() == invalid_grid && dlx.moves().empty());
+
+    // Griglia valida senza soluzione: la cella (0, 8) non ha valori
+    Sudoku impossible;
+    for (short j = 0; j < 8; ++j) {
+        impossible.set(0, j, j + 1);
+    }
+    impossible.set(4, 8, 9);
+    const std::string impossible_grid = impossible.str();
+    assert(!dlx.solve(impossible));
+    assert(impossible.str() == impossible_grid && dlx.moves().empty());
+
+    // Dopo gli errori il solver risolve ancora
+    Sudoku again;
+    assert(again.read(puzzles[0]));
+    assert(dlx.solve(again));
+    assert(again.str() ==
+        "812753649943682175675491283154237896369845721287169534"
+        "521974368438526917796318452");
+
+    // Griglia vuota e griglia già completa
+    Sudoku empty;
+    assert(dlx.solve(empty) && empty.complete() && empty.valid());
+    assert(dlx.moves().size() == 81);
+    assert(dlx.solve(again) && dlx.moves().empty() && dlx.nodes() == 1);
+
+    // Attraverso l'interfaccia comune
+    SudokuSolver& solver = dlx;
+    Sudoku through;
+    assert(through.read(puzzles[1]));
+    assert(solver.solve(through) && through.complete());
+}
+
+/**
+ * @brief Test SudokuBatch
+ */
+void batchTest() {
+    const std::string puzzles[] = {
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..",
+        "4.....8.5.3..........7......2.....6.....8.4......1......."
+        "6.3.7.5..2.....1.4......",
+        "..............3.85..1.2.......5.7.....4...1...9.......5."
+        ".....73..2.1........4...9",
+        // Senza soluzione: la cella (0, 8) non ha valori
+        "12345678....................................9"
+        "...................................."
+    };
+
+    // Input con commenti, righe vuote e una riga non valida; l'output
+    // atteso è quello della risoluzione di un Sudoku alla volta
+    std::string input("# raccolta di prova\n\n");
+    std::string expected;
+    unsigned long count = 0;
+    unsigned long failed = 0;
+    for (int k = 0; k < 50; ++k) {
+        const std::string& line = puzzles[k % 4];
+        input += line + '\n';
+        Sudoku s;
+        assert(s.read(line));
+        if (s.solve()) {
+            expected += s.str() + '\n';
+        }
+        else {
+            expected += '\n';
+            ++failed;
+        }
+        ++count;
+        if (k == 20) {
+            input += "non valida\n\n";
+            expected += '\n';
+            ++count;
+            ++failed;
+        }
+    }
+
+    // Blocchi piccoli per far girare più volte l'anello, e un solo blocco
+    const unsigned int threads[] = {1, 3, 4};
+    const std::size_t chunks[] = {1, 7, 1000};
+    for (int t = 0; t < 3; ++t) {
+        SudokuBatch batch(threads[t], chunks[t]);
+        assert(batch.threads() == threads[t]);
+        std::istringstream in(input);
+        std::ostringstream out;
+        std::ostringstream errors;
+        const SudokuBatch::Stats stats = batch.run(in, out, errors, "prova");
+        assert(out.str() == expected);
+        assert(stats.puzzles == count && stats.failed == failed);
+        assert(stats.nodes > 0 && stats.seconds >= 0);
+        assert(errors.str().find("prova:24: riga non valida\n") !=
+               std::string::npos);
+        assert(errors.str().find("prova:6: nessuna soluzione\n") !=
+               std::string::npos);
+
+        // La stessa istanza risolve un altro stream, anche vuoto
+        std::istringstream empty_in("");
+        std::ostringstream empty_out;
+        const SudokuBatch::Stats empty = batch.run(empty_in, empty_out,
+                                                   errors, "vuoto");
+        assert(empty.puzzles == 0 && empty_out.str().empty());
+    }
+
+    // Dancing Links e sola propagazione
+    SudokuBatch batch(2, 5);
+    batch.setDancingLinks(true);
+    std::istringstream in(input);
+    std::ostringstream out;
+    std::ostringstream errors;
+    assert(batch.run(in, out, errors, "dlx").failed == failed);
+    assert(out.str() == expected);
+
+    batch.setDancingLinks(false);
+    batch.setDeduceOnly(true);
+    batch.setPropagation(Sudoku::LOCKED_CANDIDATES);
+    std::istringstream deduce_in(puzzles[1] + '\n');
+    std::ostringstream deduce_out;
+    assert(batch.run(deduce_in, deduce_out, errors, "deduce").failed == 0);
+    assert(deduce_out.str() ==
+        "417369825632158947958724316825437169791586432346912758289643571"
+        "573291684164875293\n");
+}
+
+/**
+ * @brief Test SudokuLanes
+ */
+void lanesTest() {
+    const std::string lines[] = {
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..",
+        "4.....8.5.3..........7......2.....6.....8.4......1......."
+        "6.3.7.5..2.....1.4......",
+        "..............3.85..1.2.......5.7.....4...1...9.......5."
+        ".....73..2.1........4...9",
+        // Facile: risolto dalla sola propagazione
+        ".........534..7...9.7..34..6.9...3..34....7.57283.49......"
+        "4157.4..5..1.3.1.7362..",
+        // Non valido: due 8 nella prima riga
+        "8....8.....36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..",
+        // Senza soluzione: la cella (0, 8) non ha valori
+        "12345678....................................9"
+        "....................................",
+        // Vuoto
+        std::string(81, '.'),
+        // Già completo
+        "812753649943682175675491283154237896369845721287169534"
+        "521974368438526917796318452"
+    };
+
+    // 37 Sudoku: più di due gruppi, l'ultimo incompleto
+    std::vector<Sudoku> puzzles;
+    std::vector<Sudoku> expected;
+    std::size_t solvable = 0;
+    for (int k = 0; k < 37; ++k) {
+        Sudoku s;
+        assert(s.read(lines[k % 8]));
+        puzzles.push_back(s);
+        if (s.solve()) {
+            ++solvable;
+        }
+        expected.push_back(s);
+    }
+
+    const SudokuLanes::Isa isas[] = {
+        SudokuLanes::SCALAR, SudokuLanes::SSE2, SudokuLanes::AVX2
+    };
+    assert(SudokuLanes::supported(SudokuLanes::SCALAR));
+    assert(SudokuLanes::supported(SudokuLanes::bestIsa()));
+    for (int i = 0; i < 3; ++i) {
+        if (!SudokuLanes::supported(isas[i])) {
+            continue;
+        }
+        SudokuLanes lanes(isas[i]);
+        assert(lanes.isa() == isas[i]);
+
+        // Stessi risultati di Sudoku::solve; i Sudoku non risolti restano
+        // invariati
+        std::vector<Sudoku> sudokus(puzzles);
+        assert(lanes.solve(&sudokus[0], sudokus.size()) == solvable);
+        for (std::size_t k = 0; k < sudokus.size(); ++k) {
+            assert(sudokus[k].str() == expected[k].str());
+        }
+
+        // I Sudoku facili e quelli completi non arrivano alla ricerca,
+        // quelli difficili e quello vuoto sì
+        assert(lanes.searched() > 0 && lanes.searched() < 37);
+        assert(lanes.nodes() >= lanes.searched());
+
+        // Un gruppo parziale e nessun Sudoku
+        std::vector<Sudoku> few(puzzles.begin(), puzzles.begin() + 3);
+        assert(lanes.solve(&few[0], few.size()) == 3);
+        assert(few[2].str() == expected[2].str());
+        assert(lanes.solve(&few[0], 0) == 0 && lanes.searched() == 0);
+    }
+
+    // Il Sudoku facile è completato dalla propagazione
+    SudokuLanes lanes;
+    Sudoku easy;
+    assert(easy.read(lines[3]));
+    const Sudoku easy_puzzle(easy);
+    assert(lanes.solve(&easy, 1) == 1 && lanes.searched() == 0);
+    assert(isSolutionOf(easy, easy_puzzle));
+}
+
+/**
+ * @brief Sudoku di lato B · B con una cella piena ogni stride, presa da una
+ * griglia completa in cui ogni riga è la precedente spostata di B celle, o
+ * di B + 1 all'inizio di una fascia.
+ */
+template <int B>
+BasicSudoku<B> patternSudoku(int stride) {
+    const int SIZE = BasicSudoku<B>::SIZE;
+    BasicSudoku<B> s;
+    for (int i = 0; i < SIZE; ++i) {
+        for (int j = 0; j < SIZE; ++j) {
+            if ((i * SIZE + j) % stride == 0) {
+                s.set(i, j, static_cast<short>(
+                    (i % B * B + i / B + j) % SIZE + 1));
+            }
+        }
+    }
+    return s;
+}
+
+/**
+ * @brief Test BasicSudoku di lato B · B
+ *
+ * @param stride Una cella piena ogni stride nei Sudoku da risolvere.
+ */
+template <int B>
+void basicSudokuTest(int stride) {
+    typedef BasicSudoku<B> S;
+
+    // Geometria: ogni cella è nelle sue tre unità, alla posizione attesa
+    for (int k = 0; k < S::CELLS; ++k) {
+        const unsigned char* units = S::CELL_UNITS.units[k];
+        const int row = k / S::SIZE, column = k % S::SIZE;
+        assert(units[0] == row && units[1] == S::SIZE + column);
+        assert(units[2] == 2 * S::SIZE + row / B * B + column / B);
+        assert(S::UNIT_CELLS.cells[units[0]][column] == k);
+        assert(S::UNIT_CELLS.cells[units[1]][row] == k);
+        assert(S::UNIT_CELLS.cells[units[2]][row % B * B + column % B] == k);
+    }
+
+    // Griglia completa, scritta e riletta
+    const S full = patternSudoku<B>(1);
+    assert(full.valid() && full.complete());
+    S copy;
+    assert(copy.read(full.str()) && copy.str() == full.str());
+    assert(copy.str().size() == std::size_t(S::CELLS));
+
+    // Con ogni propagazione la soluzione conserva le celle piene
+    const S puzzle = patternSudoku<B>(stride);
+    assert(puzzle.valid() && !puzzle.complete());
+    const typename S::Propagation propagations[] = {
+        S::NO_PROPAGATION, S::SINGLES, S::LOCKED_CANDIDATES
+    };
+    for (int p = B <= 3 ? 0 : 1; p < 3; ++p) {
+        S s(puzzle);
+        s.setPropagation(propagations[p]);
+        assert(s.solve());
+        assert(isSolutionOf(s, puzzle));
+        std::size_t empty = 0;
+        for (int k = 0; k < S::CELLS; ++k) {
+            empty += puzzle.get(k / S::SIZE, k % S::SIZE) == 0;
+        }
+        assert(s.moves().size() == empty);
+    }
+
+    // Senza soluzione: l'ultima cella della prima riga può valere solo
+    // SIZE, che è già nell'ultima colonna
+    S impossible;
+    for (int j = 0; j + 1 < S::SIZE; ++j) {
+        impossible.set(0, j, static_cast<short>(j + 1));
+    }
+    impossible.set(S::SIZE - 1, S::SIZE - 1, S::SIZE);
+    const std::string before = impossible.str();
+    assert(impossible.valid() && !impossible.solve());
+    assert(impossible.str() == before);
+
+    // Un valore oltre SIZE non può essere letto
+    std::string line(S::CELLS, '.');
+    line[0] = S::digitChar(S::SIZE);
+    assert(copy.read(line) && copy.get(0, 0) == S::SIZE);
+    line[0] = static_cast<char>(line[0] + 1);
+    assert(!copy.read(line) && copy.get(0, 0) == S::SIZE);
+}
+
+/**
+ * @brief Test Sudoku 4x4, 16x16 e 25x25
+ */
+void sudokuSizesTest() {
+    // Le maschere hanno un bit per cifra
+    assert(sizeof(BasicSudoku<2>::digit_mask) == 2);
+    assert(sizeof(Sudoku::digit_mask) == 2);
+    assert(sizeof(BasicSudoku<4>::digit_mask) == 2);
+    assert(sizeof(BasicSudoku<5>::digit_mask) == 4);
+
+    // Dopo il 9 vengono le lettere; '0' è una cella vuota solo fino a 9x9
+    assert(BasicSudoku<4>::digitChar(10) == 'A');
+    assert(BasicSudoku<4>::digitChar(16) == 'G');
+    assert(BasicSudoku<4>::digitChar(0) == '.');
+    assert(BasicSudoku<5>::charDigit('P') == 25);
+    assert(BasicSudoku<4>::charDigit('H') == -1);
+    assert(BasicSudoku<4>::charDigit('0') == -1);
+    assert(Sudoku::charDigit('0') == 0 && Sudoku::charDigit('A') == -1);
+    assert(BasicSudoku<2>::charDigit('5') == -1);
+
+    basicSudokuTest<2>(3);
+    basicSudokuTest<3>(3);
+    basicSudokuTest<4>(2);
+    basicSudokuTest<5>(2);
+
+    // Un 16x16 con soluzione unica: le propagazioni danno la stessa
+    const std::string line16 =
+        "..B..6..2E3A...5A......C8.7..1..F.9.A.2..B.......7.81..D5.....E2"
+        "G...8C.4.....5...4.6G..1....A27E...E5....C.81G....D....AB31....."
+        "....B.3.D1..2...9.....72.....6.C.G.3.F.8...E.91...4...D..F..G..."
+        "........4...9........G.9F..CB.....G.7.4.A2....5FC65F.....G.D.7..";
+    BasicSudoku<4> singles, locked;
+    assert(singles.read(line16) && locked.read(line16));
+    const BasicSudoku<4> puzzle16(singles);
+    locked.setPropagation(BasicSudoku<4>::LOCKED_CANDIDATES);
+    assert(singles.solve() && locked.solve());
+    assert(isSolutionOf(singles, puzzle16));
+    assert(singles.str() == locked.str());
+    assert(locked.nodes() <= singles.nodes());
+}
+
+/**
+ * @brief Test conteggio delle soluzioni
+ */
+void countTest() {
+    const std::string puzzle =
+        "8..........36......7..9.2...5...7.......457.....1...3..."
+        "1....68..85...1..9....4..";
+    const std::string solution =
+        "812753649943682175675491283154237896369845721287169534"
+        "521974368438526917796318452";
+
+    // Soluzione unica: la griglia resta invariata
+    Sudoku s;
+    assert(s.read(puzzle));
+    for (int p = 0; p < 3; ++p) {
+        s.setPropagation(static_cast<Sudoku::Propagation>(p));
+        assert(s.countSolutions(2) == 1);
+        assert(s.solutions() == 1 && s.nodes() > 0);
+        assert(s.str() == puzzle && s.moves().empty());
+        assert(s.countSolutions(1) == 1 && s.str() == puzzle);
+    }
+    s.setPropagation(Sudoku::SINGLES);
+    assert(s.solve() && s.str() == solution);
+
+    // Il rettangolo 2 3 / 3 2 nelle righe 0 e 1, colonne 2 e 5, ha due
+    // soluzioni
+    std::string two = solution;
+    two[2] = two[5] = two[9 + 2] = two[9 + 5] = '.';
+    assert(s.read(two) && s.countSolutions(10) == 2);
+    assert(s.countSolutions(2) == 2 && s.str() == two);
+
+    // Griglie non valide o senza soluzione
+    std::string invalid = puzzle;
+    invalid[1] = '8';
+    assert(s.read(invalid) && s.countSolutions(2) == 0);
+    assert(s.read("12345678....................................9"
+                  "....................................") &&
+           s.countSolutions(2) == 0);
+
+    // Il 4x4 vuoto ha 288 soluzioni; il limite ferma il conteggio
+    BasicSudoku<2> small;
+    assert(small.countSolutions(1000) == 288);
+    assert(small.countSolutions(100) == 100);
+
+    // La divisione copre tutte le soluzioni con rami disgiunti
+    std::vector<std::string> tasks;
+    assert(small.split(2, tasks) == 0);
+    assert(tasks.size() > 1);
+    unsigned long long total = 0;
+    for (std::size_t k = 0; k < tasks.size(); ++k) {
+        BasicSudoku<2> task;
+        assert(task.read(tasks[k]));
+        total += task.countSolutions(1000);
+    }
+    assert(total == 288 && small.str() == std::string(16, '.'));
+    tasks.clear();
+    assert(s.read(solution) && s.split(3, tasks) == 1 && tasks.empty());
+
+    // Un SudokuMonitor ferma il conteggio
+    Sudoku empty;
+    CountingMonitor once(1);
+    assert(empty.countSolutions(1000000, once, 100) < 1000000);
+    assert(empty.interrupted() && empty.str() == std::string(81, '.'));
+
+    // In parallelo, con 1, 2, 3 thread e uno per core
+    const unsigned int threads[] = {1, 2, 3, 0};
+    for (int i = 0; i < 4; ++i) {
+        BasicSolutionCounter<2> small_counter(threads[i]);
+        assert(small_counter.count(small, 1000) == 288);
+        assert(!small_counter.interrupted());
+        assert(small_counter.count(small, 100) == 100);
+        assert(small_counter.nodes() > 0);
+        assert((small_counter.tasks() > 0) == (small_counter.threads() > 1));
+
+        SolutionCounter counter(threads[i]);
+        assert(s.read(puzzle) && counter.unique(s) && s.str() == puzzle);
+        assert(s.read(two) && counter.count(s, 10) == 2);
+        assert(!counter.unique(s));
+        assert(s.read(invalid) && counter.count(s, 2) == 0);
+        assert(counter.count(empty, 50) == 50);
+    }
+
+    // cancel() da un altro thread ferma un conteggio che non finirebbe
+    SolutionCounter counter(2);
+    std::atomic<bool> done(false);
+    std::thread canceller([&]() {
+        while (!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            counter.cancel();
+        }
+    });
+    const unsigned long long found = counter.count(empty, ~0ull);
+    done = true;
+    canceller.join();
+    assert(counter.interrupted() && found < ~0ull);
+
+    // La richiesta resta valida fino a reset(), anche se arriva prima del
+    // conteggio
+    assert(counter.count(empty, ~0ull) < ~0ull && counter.interrupted());
+    counter.reset();
+    assert(counter.count(empty, 10) == 10 && !counter.interrupted());
+    SolutionCounter early(1);
+    early.cancel();
+    assert(early.count(empty, ~0ull) < ~0ull && early.interrupted());
+    early.reset();
+    assert(early.count(empty, 10) == 10 && !early.interrupted());
+}
+
+int main() {
+
+#ifndef NDEBUG
+    constructorTest();
+    std::cout << "Test costruttori completati con successo." << std::endl;
+
+    assignmentTest();
+    std::cout << "Test assegnamento completati con successo." << std::endl;
+
+    editTest();
+    std::cout
+        << "Test modifiche al contenuto del Digraph completate con successo."
+        << std::endl;
+
+    iteratorTest();
+    std::cout << "Test iteratori completati con successo." << std::endl;
+    
+    constnessTest();
+    std::cout << "Test constness completati con successo." << std::endl;
+
+    exportTest();
+    std::cout << "Test esportazione completati con successo." << std::endl;
+
+    allocatorTest();
+    std::cout << "Test allocatori completati con successo." << std::endl;
+
+    transposeTest();
+    std::cout << "Test trasposta completati con successo." << std::endl;
+
+    setOperationsTest();
+    std::cout << "Test operazioni tra grafi completati con successo."
+              << std::endl;
+
+    subgraphTest();
+    std::cout << "Test sottografi completati con successo." << std::endl;
+
+    statsTest();
+    std::cout << "Test statistiche completati con successo." << std::endl;
+
+    fixedDigraphTest();
+    std::cout << "Test FixedDigraph completati con successo." << std::endl;
+
+    copyOnWriteTest();
+    std::cout << "Test copy-on-write completati con successo." << std::endl;
+
+    journalTest();
+    std::cout << "Test journal completati con successo." << std::endl;
+
+    mappedTest();
+    std::cout << "Test grafo su file mappato completati con successo."
+              << std::endl;
+
+    cycleCountTest();
+    std::cout << "Test conteggio cicli completati con successo." << std::endl;
+
+    rankingTest();
+    std::cout << "Test PageRank e HITS completati con successo." << std::endl;
+
+    equalityTest();
+    std::cout << "Test uguaglianza completati con successo." << std::endl;
+
+    dominatorTest();
+    std::cout << "Test dominatori completati con successo." << std::endl;
+
+    sudokuTest();
+    std::cout << "Test Sudoku completati con successo." << std::endl;
+
+    monitorTest();
+    std::cout << "Test SudokuMonitor completati con successo." << std::endl;
+
+    dancingLinksTest();
+    std::cout << "Test Dancing Links completati con successo." << std::endl;
+
+    batchTest();
+    std::cout << "Test SudokuBatch completati con successo." << std::endl;
+
+    lanesTest();
+    std::cout << "Test SudokuLanes completati con successo." << std::endl;
+
+    sudokuSizesTest();
+    std::cout << "Test Sudoku 4x4, 16x16 e 25x25 completati con successo."
+              << std::endl;
+
+    countTest();
+    std::cout << "Test conteggio soluzioni completati con successo."
+              << std::endl;
 
     std::cout << "-----------------------------" << std::endl;
     std::cout << "Test completati con successo." << std::endl;
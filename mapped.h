@@ -0,0 +1,258 @@
+#ifndef mapped_h
+#define mapped_h
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * @brief Definita se MappedArena è disponibile sulla piattaforma.
+ */
+#define MAPPED_ARENA_AVAILABLE 1
+
+#include <cerrno> // errno
+#include <cstddef> // std::size_t
+#include <cstdlib> // mkstemp
+#include <new> // std::bad_alloc
+#include <string> // std::string
+#include <system_error> // std::system_error std::generic_category
+
+#include <fcntl.h> // posix_fadvise
+#include <sys/mman.h> // mmap munmap madvise msync
+#include <unistd.h> // close ftruncate unlink sysconf
+#include <vector> // std::vector
+
+
+/**
+ * @brief Arena monotona su un file mappato in memoria.
+ *
+ * Lo spazio degli indirizzi viene riservato tutto alla costruzione e
+ * corrisponde a un file sparso di capacity byte: le pagine occupano disco e
+ * memoria solo quando vengono scritte, e quelle non usate di recente possono
+ * essere scaricate sul file dal sistema operativo. Così un grafo può essere
+ * più grande della memoria fisica.
+ *
+ * Il file è memoria di appoggio anonima: viene creato con un nome nuovo
+ * nella directory indicata, senza toccare file esistenti, e rimosso subito
+ * dopo l'apertura, quindi non è visibile ad altri processi e il suo
+ * contenuto sparisce con l'arena. Come in MonotonicArena le singole
+ * deallocazioni non hanno effetto, quindi conviene costruire il grafo con
+ * tutti i nodi e poi aggiungere gli archi, che non riallocano la matrice.
+ */
+class MappedArena {
+    int _fd; ///< Descrittore del file
+    char* _base; ///< Inizio della mappatura
+    std::size_t _capacity; ///< Dimensione della mappatura in byte
+    std::size_t _used; ///< Byte della mappatura già distribuiti
+    std::size_t _allocated; ///< Byte richiesti dalle allocazioni
+    std::size_t _page; ///< Dimensione di una pagina
+
+    MappedArena(const MappedArena&); // Non copiabile
+    MappedArena& operator=(const MappedArena&); // Non assegnabile
+
+    /**
+     * @brief Applica advice alle pagine che contengono [p, p + bytes).
+     *
+     * Gli errori vengono ignorati: i consigli non cambiano il contenuto
+     * della memoria.
+     */
+    void advise(const void* p, std::size_t bytes, int advice) const {
+        if (bytes == 0) {
+            return;
+        }
+        const std::size_t begin = reinterpret_cast<std::size_t>(p) &
+                                  ~(_page - 1);
+        const std::size_t end = reinterpret_cast<std::size_t>(p) + bytes;
+        ::madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+    }
+
+public:
+
+    /**
+     * @brief Costruttore, crea il file di appoggio e lo mappa in memoria.
+     *
+     * Il file viene creato con mkstemp, con un nome che non esiste ancora,
+     * e rimosso subito: arene diverse nella stessa directory, anche di
+     * processi diversi, non interferiscono.
+     *
+     * @param directory Directory in cui creare il file, ad esempio "/tmp";
+     *  deve stare su un file system con spazio per capacity byte.
+     * @param capacity Byte massimi distribuiti dall'arena.
+     * @throw std::system_error se il file non può essere creato o mappato
+     */
+    MappedArena(const std::string& directory, std::size_t capacity) :
+            _fd(-1), _base(nullptr), _capacity(0), _used(0), _allocated(0),
+            _page(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))) {
+        _capacity = (capacity + _page - 1) / _page * _page;
+        if (_capacity == 0) {
+            _capacity = _page;
+        }
+
+        const std::string pattern = directory + "/MappedArena.XXXXXX";
+        std::vector<char> path(pattern.begin(), pattern.end());
+        path.push_back('\0');
+        _fd = ::mkstemp(&path[0]);
+        if (_fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "MappedArena: mkstemp " + pattern);
+        }
+        ::unlink(&path[0]);
+
+        if (::ftruncate(_fd, static_cast<off_t>(_capacity)) != 0) {
+            const int error = errno;
+            ::close(_fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "MappedArena: ftruncate");
+        }
+
+        void* base = ::mmap(nullptr, _capacity, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, _fd, 0);
+        if (base == MAP_FAILED) {
+            const int error = errno;
+            ::close(_fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "MappedArena: mmap");
+        }
+        _base = static_cast<char*>(base);
+    }
+
+    /**
+     * @brief Distruttore, rimuove la mappatura e chiude il file.
+     */
+    ~MappedArena() {
+        ::munmap(_base, _capacity);
+        ::close(_fd);
+    }
+
+    /**
+     * @brief Alloca bytes byte allineati ad align.
+     *
+     * La memoria è azzerata alla prima allocazione.
+     *
+     * @param bytes Numero di byte richiesti.
+     * @param align Allineamento richiesto, potenza di 2.
+     * @return Puntatore alla memoria allocata.
+     * @throw std::bad_alloc se la capacità è esaurita
+     */
+    void* allocate(std::size_t bytes, std::size_t align) {
+        const std::size_t start = (_used + align - 1) & ~(align - 1);
+        if (start > _capacity || _capacity - start < bytes) {
+            throw std::bad_alloc();
+        }
+        _used = start + bytes;
+        _allocated += bytes;
+        return _base + start;
+    }
+
+    /**
+     * @brief Le singole deallocazioni vengono ignorate.
+     */
+    void deallocate(void*, std::size_t) {}
+
+    /**
+     * @brief Ritorna il numero di byte distribuiti dall'arena.
+     */
+    std::size_t allocated() const {
+        return _allocated;
+    }
+
+    /**
+     * @brief Ritorna la capacità dell'arena in byte.
+     */
+    std::size_t capacity() const {
+        return _capacity;
+    }
+
+    /**
+     * @brief Suggerisce che [p, p + bytes) verrà letto a breve.
+     *
+     * Il sistema operativo può caricare le pagine dal file in anticipo.
+     */
+    void willNeed(const void* p, std::size_t bytes) const {
+        advise(p, bytes, MADV_WILLNEED);
+    }
+
+    /**
+     * @brief Attiva o disattiva la lettura sequenziale di [p, p + bytes).
+     *
+     * In modalità sequenziale il sistema operativo legge in anticipo più
+     * pagine e libera presto quelle già lette.
+     */
+    void sequential(const void* p, std::size_t bytes, bool on) const {
+        advise(p, bytes, on ? MADV_SEQUENTIAL : MADV_NORMAL);
+    }
+
+    /**
+     * @brief Scrive tutte le pagine sul file e le toglie dalla memoria.
+     *
+     * Il contenuto non cambia, ma i successivi accessi devono rileggerlo dal
+     * file. Usata per misurare gli accessi a freddo.
+     */
+    void evict() {
+        ::msync(_base, _capacity, MS_SYNC);
+        ::madvise(_base, _capacity, MADV_DONTNEED);
+#if defined(POSIX_FADV_DONTNEED)
+        ::posix_fadvise(_fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    }
+};
+
+/**
+ * @brief Allocatore che ottiene la memoria da una MappedArena.
+ *
+ * Oltre alle funzioni di un allocatore espone i consigli di accesso
+ * dell'arena, che Digraph usa per prefetch e sequentialScan.
+ * Due MappedAllocator sono uguali se riferiscono la stessa arena.
+ *
+ * @param T tipo degli oggetti allocati
+ */
+template <typename T>
+class MappedAllocator {
+    MappedArena* _arena; ///< Arena da cui ottenere la memoria
+
+    template <typename U>
+    friend class MappedAllocator;
+
+public:
+    typedef T value_type;
+
+    /**
+     * @brief Costruttore, l'allocatore riferisce arena.
+     */
+    explicit MappedAllocator(MappedArena& arena) : _arena(&arena) {}
+
+    /**
+     * @brief Costruttore di conversione usato da rebind.
+     */
+    template <typename U>
+    MappedAllocator(const MappedAllocator<U>& other) :
+            _arena(other._arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    void willNeed(const void* p, std::size_t bytes) const {
+        _arena->willNeed(p, bytes);
+    }
+
+    void sequential(const void* p, std::size_t bytes, bool on) const {
+        _arena->sequential(p, bytes, on);
+    }
+
+    template <typename U>
+    bool operator==(const MappedAllocator<U>& other) const {
+        return _arena == other._arena;
+    }
+
+    template <typename U>
+    bool operator!=(const MappedAllocator<U>& other) const {
+        return _arena != other._arena;
+    }
+};
+
+#endif // __unix__ || __APPLE__
+
+#endif //mapped_h
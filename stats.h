@@ -0,0 +1,172 @@
+#ifndef stats_h
+#define stats_h
+
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+
+
+/**
+ * @brief Contatori degli eventi rilevanti per le prestazioni di Digraph.
+ */
+struct DigraphCounters {
+    unsigned long long comparisons; ///< Confronti con il funtore E in nodeIndex
+    unsigned long long rebuilds; ///< Ricostruzioni complete della matrice
+    unsigned long long bytes_allocated; ///< Byte ottenuti dall'allocatore
+    unsigned long long bytes_copied; ///< Byte di nodi e matrici copiati
+
+    DigraphCounters() : comparisons(0), rebuilds(0), bytes_allocated(0),
+            bytes_copied(0) {}
+};
+
+/**
+ * @brief Policy di statistiche disattivata.
+ *
+ * Tutte le funzioni sono vuote e la classe non ha attributi: usata come
+ * base privata di Digraph non occupa memoria e il compilatore elimina le
+ * chiamate. snapshot() ritorna sempre contatori a zero.
+ */
+struct NoDigraphStats {
+    void countComparisons(unsigned long long) const {}
+    void countRebuild() const {}
+    void countAllocated(std::size_t) const {}
+    void countCopied(std::size_t) const {}
+    void merge(const NoDigraphStats&) const {}
+
+    DigraphCounters snapshot() const {
+        return DigraphCounters();
+    }
+
+    void reset() {}
+
+    static DigraphCounters globalSnapshot() {
+        return DigraphCounters();
+    }
+
+    static void globalReset() {}
+};
+
+/**
+ * @brief Policy di statistiche attiva.
+ *
+ * Conta gli eventi sia per istanza sia globalmente. Tutti i contatori sono
+ * atomici e aggiornati con memory_order_relaxed: nodeIndex e hasEdge
+ * contano i confronti anche se const, quindi più thread possono leggere
+ * lo stesso Digraph, e i contatori possono essere letti mentre altri
+ * thread lo usano. Ogni contatore è coerente da solo, uno snapshot preso
+ * durante le modifiche può non esserlo tra contatori diversi.
+ */
+class DigraphStats {
+    typedef std::atomic<unsigned long long> counter;
+
+    /**
+     * @brief Contatori atomici, dell'istanza o globali.
+     */
+    struct Counters {
+        counter comparisons;
+        counter rebuilds;
+        counter bytes_allocated;
+        counter bytes_copied;
+    };
+
+    mutable Counters _counters; ///< Contatori dell'istanza
+
+    /**
+     * @brief Contatori globali, condivisi da tutti i Digraph con questa
+     * policy.
+     */
+    static Counters& global() {
+        static Counters instance = {{0}, {0}, {0}, {0}};
+        return instance;
+    }
+
+    static void add(counter& c, unsigned long long n) {
+        c.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static DigraphCounters load(const Counters& from) {
+        DigraphCounters c;
+        c.comparisons = from.comparisons.load(std::memory_order_relaxed);
+        c.rebuilds = from.rebuilds.load(std::memory_order_relaxed);
+        c.bytes_allocated =
+            from.bytes_allocated.load(std::memory_order_relaxed);
+        c.bytes_copied = from.bytes_copied.load(std::memory_order_relaxed);
+        return c;
+    }
+
+    static void store(Counters& to, const DigraphCounters& c) {
+        to.comparisons.store(c.comparisons, std::memory_order_relaxed);
+        to.rebuilds.store(c.rebuilds, std::memory_order_relaxed);
+        to.bytes_allocated.store(c.bytes_allocated,
+                                 std::memory_order_relaxed);
+        to.bytes_copied.store(c.bytes_copied, std::memory_order_relaxed);
+    }
+
+public:
+    DigraphStats() {
+        store(_counters, DigraphCounters());
+    }
+
+    void countComparisons(unsigned long long n) const {
+        add(_counters.comparisons, n);
+        add(global().comparisons, n);
+    }
+
+    void countRebuild() const {
+        add(_counters.rebuilds, 1);
+        add(global().rebuilds, 1);
+    }
+
+    void countAllocated(std::size_t bytes) const {
+        add(_counters.bytes_allocated, bytes);
+        add(global().bytes_allocated, bytes);
+    }
+
+    void countCopied(std::size_t bytes) const {
+        add(_counters.bytes_copied, bytes);
+        add(global().bytes_copied, bytes);
+    }
+
+    /**
+     * @brief Somma ai contatori dell'istanza quelli di other.
+     *
+     * Usata quando un Digraph temporaneo viene adottato da un altro, i
+     * contatori globali sono già aggiornati.
+     */
+    void merge(const DigraphStats& other) const {
+        const DigraphCounters c = other.snapshot();
+        add(_counters.comparisons, c.comparisons);
+        add(_counters.rebuilds, c.rebuilds);
+        add(_counters.bytes_allocated, c.bytes_allocated);
+        add(_counters.bytes_copied, c.bytes_copied);
+    }
+
+    /**
+     * @brief Ritorna una copia dei contatori dell'istanza.
+     */
+    DigraphCounters snapshot() const {
+        return load(_counters);
+    }
+
+    /**
+     * @brief Azzera i contatori dell'istanza.
+     */
+    void reset() {
+        store(_counters, DigraphCounters());
+    }
+
+    /**
+     * @brief Ritorna una copia dei contatori globali.
+     */
+    static DigraphCounters globalSnapshot() {
+        return load(global());
+    }
+
+    /**
+     * @brief Azzera i contatori globali.
+     */
+    static void globalReset() {
+        store(global(), DigraphCounters());
+    }
+};
+
+#endif //stats_h
@@ -0,0 +1,362 @@
+#ifndef batch_h
+#define batch_h
+
+#include <algorithm> // std::max
+#include <chrono> // std::chrono::steady_clock
+#include <condition_variable> // std::condition_variable
+#include <cstddef> // std::size_t
+#include <istream> // std::istream
+#include <mutex> // std::mutex std::unique_lock
+#include <ostream> // std::ostream
+#include <string> // std::string std::getline std::to_string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include "sudoku.h"
+#include "dancing_links.h"
+
+/**
+ * @file batch.h
+ * @brief Risoluzione in parallelo di grandi raccolte di Sudoku.
+ */
+
+/**
+ * @brief Risolve i Sudoku di uno stream con più thread, scrivendo le
+ * soluzioni nell'ordine dell'input.
+ *
+ * Il formato è quello della riga di comando: un Sudoku di 81 caratteri per
+ * riga, righe vuote e commenti '#' ignorati, una riga di output per Sudoku
+ * (vuota se la riga non è valida o il Sudoku non ha soluzioni) e i
+ * messaggi di errore su uno stream a parte.
+ *
+ * Il thread chiamante legge l'input a blocchi di chunk_size Sudoku e
+ * scrive i blocchi risolti; i thread di lavoro prendono i blocchi nell'ordine
+ * in cui sono stati letti. I blocchi sono un anello di dimensione fissa:
+ * prima di riempire di nuovo un blocco il lettore aspetta che sia stato
+ * risolto e lo scrive, così l'output resta nell'ordine dell'input e in
+ * memoria non ci sono mai più di 2 · threads blocchi, qualunque sia la
+ * lunghezza dello stream.
+ *
+ * Le righe, le soluzioni e gli stati dei solver vengono allocati una volta
+ * per chiamata a run e poi riusati: ogni thread ha il suo Sudoku e il suo
+ * solver, e risolvere un blocco non alloca memoria salvo per i messaggi di
+ * errore.
+ */
+class SudokuBatch {
+public:
+
+    /**
+     * @brief Contatori di una chiamata a run.
+     */
+    struct Stats {
+        unsigned long puzzles; ///< Sudoku letti
+        unsigned long failed; ///< Sudoku non validi o senza soluzione
+        unsigned long long nodes; ///< Nodi visitati
+        double seconds; ///< Durata di run
+
+        Stats() : puzzles(0), failed(0), nodes(0), seconds(0) {}
+
+        /**
+         * @brief Ritorna i Sudoku elaborati al secondo.
+         */
+        double puzzlesPerSecond() const {
+            return seconds > 0 ? puzzles / seconds : 0.0;
+        }
+    };
+
+private:
+
+    /**
+     * @brief Blocco di Sudoku letti insieme, con il relativo output.
+     */
+    struct Chunk {
+        std::vector<std::string> lines; ///< Righe dei Sudoku
+        std::vector<unsigned long> numbers; ///< Numeri di riga nell'input
+        std::size_t size; ///< Righe usate
+        std::string output; ///< Soluzioni, una per riga
+        std::string errors; ///< Messaggi di errore
+        unsigned long failed; ///< Sudoku non risolti
+        unsigned long long nodes; ///< Nodi visitati
+        bool done; ///< Risolto e non ancora scritto
+    };
+
+    unsigned int _threads; ///< Thread di lavoro
+    std::size_t _chunk_size; ///< Sudoku per blocco
+    Sudoku::Propagation _propagation; ///< Deduzioni usate
+    bool _dancing_links; ///< DancingLinksSolver al posto del backtracking
+    bool _deduce_only; ///< Solo propagazione, senza ricerca
+
+    std::vector<Chunk> _chunks; ///< Anello dei blocchi
+    std::string _name; ///< Nome dello stream nei messaggi di errore
+    std::mutex _mutex; ///< Protegge i contatori e Chunk::done
+    std::condition_variable _filled; ///< Blocco letto o input finito
+    std::condition_variable _solved; ///< Un blocco è stato risolto
+    unsigned long _next_fill; ///< Blocchi letti
+    unsigned long _next_solve; ///< Blocchi presi dai thread di lavoro
+    bool _finished; ///< Non ci sono altri blocchi da leggere
+
+    SudokuBatch(const SudokuBatch&); // Non copiabile
+    SudokuBatch& operator=(const SudokuBatch&); // Non assegnabile
+
+    /**
+     * @brief Aggiunge a output la griglia di sudoku nel formato di
+     * Sudoku::str, senza stringhe temporanee.
+     */
+    static void appendGrid(const Sudoku& sudoku, std::string& output) {
+        for (int i = 0; i < Sudoku::SIZE; ++i) {
+            for (int j = 0; j < Sudoku::SIZE; ++j) {
+                const short value = sudoku.get(i, j);
+                output.push_back(value == 0 ? '.'
+                                            : static_cast<char>('0' + value));
+            }
+        }
+        output.push_back('\n');
+    }
+
+    /**
+     * @brief Risolve le righe di chunk con lo stato di un thread.
+     */
+    void solveChunk(Chunk& chunk, Sudoku& sudoku, SudokuSolver& solver) {
+        chunk.output.clear();
+        chunk.errors.clear();
+        chunk.failed = 0;
+        chunk.nodes = 0;
+        for (std::size_t k = 0; k < chunk.size; ++k) {
+            const char* error = nullptr;
+            if (!sudoku.read(chunk.lines[k])) {
+                error = ": riga non valida\n";
+            }
+            else if (_deduce_only) {
+                if (!sudoku.deduce()) {
+                    error = ": nessuna soluzione\n";
+                }
+                chunk.nodes += sudoku.nodes();
+            }
+            else {
+                if (!solver.solve(sudoku)) {
+                    error = ": nessuna soluzione\n";
+                }
+                chunk.nodes += solver.nodes();
+            }
+
+            if (error != nullptr) {
+                ++chunk.failed;
+                chunk.errors += _name + ':' +
+                                std::to_string(chunk.numbers[k]) + error;
+                chunk.output.push_back('\n');
+            }
+            else {
+                appendGrid(sudoku, chunk.output);
+            }
+        }
+    }
+
+    /**
+     * @brief Ciclo di un thread di lavoro: risolve i blocchi letti finché
+     * l'input non è finito.
+     */
+    void work() {
+        Sudoku sudoku;
+        sudoku.setPropagation(_propagation);
+        BacktrackingSolver backtracking(_propagation);
+        DancingLinksSolver dancing_links;
+        SudokuSolver& solver = _dancing_links
+            ? static_cast<SudokuSolver&>(dancing_links) : backtracking;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            while (_next_solve == _next_fill && !_finished) {
+                _filled.wait(lock);
+            }
+            if (_next_solve == _next_fill) {
+                return;
+            }
+            Chunk& chunk = _chunks[_next_solve % _chunks.size()];
+            ++_next_solve;
+
+            lock.unlock();
+            solveChunk(chunk, sudoku, solver);
+            lock.lock();
+
+            chunk.done = true;
+            _solved.notify_one();
+        }
+    }
+
+    /**
+     * @brief Legge da in fino a _chunk_size Sudoku.
+     *
+     * @param number Numero dell'ultima riga letta, aggiornato.
+     */
+    void fillChunk(Chunk& chunk, std::istream& in, unsigned long& number) {
+        chunk.size = 0;
+        while (chunk.size < _chunk_size &&
+                std::getline(in, chunk.lines[chunk.size])) {
+            ++number;
+            const std::string& line = chunk.lines[chunk.size];
+            if (line.empty() || line[0] == '#' || line == "\r") {
+                continue;
+            }
+            chunk.numbers[chunk.size] = number;
+            ++chunk.size;
+        }
+    }
+
+    /**
+     * @brief Aspetta che il blocco letto per numero sequence sia risolto e
+     * lo scrive.
+     */
+    void writeChunk(unsigned long sequence, std::ostream& out,
+            std::ostream& errors, Stats& stats) {
+        Chunk& chunk = _chunks[sequence % _chunks.size()];
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!chunk.done) {
+                _solved.wait(lock);
+            }
+            chunk.done = false;
+        }
+        out.write(chunk.output.data(), chunk.output.size());
+        errors.write(chunk.errors.data(), chunk.errors.size());
+        stats.puzzles += chunk.size;
+        stats.failed += chunk.failed;
+        stats.nodes += chunk.nodes;
+    }
+
+    /**
+     * @brief Segnala ai thread di lavoro che l'input è finito e li aspetta.
+     */
+    void finish(std::vector<std::thread>& workers) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _finished = true;
+        }
+        _filled.notify_all();
+        for (std::size_t t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+    }
+
+public:
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param threads Thread di lavoro, 0 per usarne uno per core.
+     * @param chunk_size Sudoku per blocco.
+     * @pre chunk_size > 0
+     */
+    explicit SudokuBatch(unsigned int threads = 0,
+            std::size_t chunk_size = 256) :
+            _threads(threads), _chunk_size(chunk_size),
+            _propagation(Sudoku::SINGLES), _dancing_links(false),
+            _deduce_only(false), _next_fill(0), _next_solve(0),
+            _finished(false) {
+        assert(chunk_size > 0);
+        if (_threads == 0) {
+            _threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    /**
+     * @brief Imposta le deduzioni usate dai solver.
+     */
+    void setPropagation(Sudoku::Propagation propagation) {
+        _propagation = propagation;
+    }
+
+    /**
+     * @brief Risolve con DancingLinksSolver invece che con
+     * BacktrackingSolver.
+     */
+    void setDancingLinks(bool dancing_links) {
+        _dancing_links = dancing_links;
+    }
+
+    /**
+     * @brief Applica solo la propagazione (Sudoku::deduce), senza ricerca.
+     */
+    void setDeduceOnly(bool deduce_only) {
+        _deduce_only = deduce_only;
+    }
+
+    /**
+     * @brief Ritorna il numero di thread di lavoro.
+     */
+    unsigned int threads() const {
+        return _threads;
+    }
+
+    /**
+     * @brief Risolve tutti i Sudoku letti da in.
+     *
+     * @param in Stream da leggere.
+     * @param out Stream delle soluzioni, una riga per Sudoku.
+     * @param errors Stream dei messaggi di errore.
+     * @param name Nome di in nei messaggi di errore.
+     * @return I contatori di questa chiamata.
+     * @throw std::system_error se un thread non può essere creato
+     */
+    Stats run(std::istream& in, std::ostream& out, std::ostream& errors,
+            const std::string& name) {
+        typedef std::chrono::steady_clock clock;
+
+        const clock::time_point start = clock::now();
+        _name = name;
+        _next_fill = 0;
+        _next_solve = 0;
+        _finished = false;
+        _chunks.resize(2 * _threads);
+        for (std::size_t c = 0; c < _chunks.size(); ++c) {
+            Chunk& chunk = _chunks[c];
+            chunk.lines.resize(_chunk_size);
+            chunk.numbers.resize(_chunk_size);
+            chunk.output.reserve(_chunk_size * (Sudoku::CELLS + 1));
+            chunk.size = 0;
+            chunk.done = false;
+        }
+
+        std::vector<std::thread> workers;
+        try {
+            for (unsigned int t = 0; t < _threads; ++t) {
+                workers.push_back(std::thread(&SudokuBatch::work, this));
+            }
+        } catch(...) {
+            finish(workers);
+            throw;
+        }
+
+        Stats stats;
+        unsigned long number = 0;
+        for (;;) {
+            // Un blocco viene riempito di nuovo solo dopo essere stato
+            // scritto
+            if (_next_fill >= _chunks.size()) {
+                writeChunk(_next_fill - _chunks.size(), out, errors, stats);
+            }
+            Chunk& chunk = _chunks[_next_fill % _chunks.size()];
+            fillChunk(chunk, in, number);
+            if (chunk.size == 0) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_next_fill;
+            }
+            _filled.notify_one();
+        }
+
+        const unsigned long pending = _next_fill < _chunks.size()
+            ? _next_fill : _chunks.size() - 1;
+        for (unsigned long s = _next_fill - pending; s < _next_fill; ++s) {
+            writeChunk(s, out, errors, stats);
+        }
+        finish(workers);
+
+        stats.seconds = std::chrono::duration<double>(
+            clock::now() - start).count();
+        return stats;
+    }
+};
+
+#endif //batch_h
@@ -0,0 +1,392 @@
+#include <iostream> // std::cout std::cerr
+#include <fstream> // std::ifstream
+#include <string> // std::string std::getline
+#include <vector> // std::vector
+#include <chrono> // std::chrono::steady_clock
+#include <sstream> // std::istringstream
+
+#include "sudoku.h"
+#include "dancing_links.h"
+#include "batch.h"
+#include "lanes.h"
+#include "counter.h"
+
+/**
+ * @file bench.cpp
+ * @brief Benchmark del solver di Sudoku.
+ *
+ * Uso: sudoku_bench.exe file...
+ *
+ * Ogni file è una raccolta di Sudoku nel formato di BasicSudoku::read, tutti
+ * della stessa dimensione: 81 caratteri per riga per il Sudoku 9x9, 256 per
+ * il 16x16, 625 per il 25x25. Per ogni raccolta scrive una riga CSV con le
+ * colonne corpus,solver,puzzles,solved,seconds,puzzles_per_sec,nodes,
+ * nodes_per_puzzle. I Sudoku vengono letti prima della misura, quindi il
+ * tempo comprende solo la risoluzione.
+ *
+ * Ogni raccolta viene risolta con BacktrackingSolver senza propagazione
+ * (solver "bitmask"), con i singoli (solver "singles") e con i candidati
+ * bloccati (solver "locked"), con DancingLinksSolver (solver "dlx") e con
+ * la ricerca originale dell'applicazione Qt (solver "valid_cell"),
+ * riportata qui per confronto: prima cella vuota in ordine di riga e
+ * valid_cell per ogni cifra provata. Il solver "batch" risolve la raccolta
+ * con SudokuBatch, un thread per core e i singoli, a partire dal testo del
+ * file: il tempo comprende anche la lettura e la scrittura delle soluzioni.
+ * I solver "lanes_scalar", "lanes_sse2" e "lanes_avx2" risolvono la
+ * raccolta con SudokuLanes e il kernel indicato, se il processore lo
+ * supporta; i nodi sono quelli di Sudoku::solve sui Sudoku che la
+ * propagazione vettoriale non completa.
+ *
+ * Le raccolte 16x16 e 25x25 vengono risolte solo da BasicSudoku::solve con i
+ * singoli ("singles") e con i candidati bloccati ("locked"): senza
+ * propagazione la ricerca richiede secondi per ogni Sudoku 16x16.
+ *
+ * Per ogni raccolta il solver "unique" controlla l'unicità della soluzione
+ * contando le soluzioni fino a due con BasicSolutionCounter su un thread
+ * (cioè con BasicSudoku::countSolutions) e "unique_parallel" con un thread
+ * per core; solved è il numero di Sudoku con una sola soluzione.
+ */
+
+/**
+ * @brief Solver originale di MainWindow: per ogni cifra provata
+ * valid_cell rilegge riga, colonna e casella.
+ */
+class ValidCellSolver : public SudokuSolver {
+    short _grid[Sudoku::SIZE][Sudoku::SIZE];
+
+    bool validCell(int row, int column) const {
+        const short number = _grid[row][column];
+        for (int i = 0; i < Sudoku::SIZE; ++i) {
+            if (i != column && _grid[row][i] == number) {
+                return false;
+            }
+        }
+        for (int i = 0; i < Sudoku::SIZE; ++i) {
+            if (i != row && _grid[i][column] == number) {
+                return false;
+            }
+        }
+        const int box_row = row - row % Sudoku::BOX;
+        const int box_column = column - column % Sudoku::BOX;
+        for (int i = box_row; i < box_row + Sudoku::BOX; ++i) {
+            for (int j = box_column; j < box_column + Sudoku::BOX; ++j) {
+                if ((i != row || j != column) && _grid[i][j] == number) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool findEmptyCell(int& row, int& column) const {
+        for (row = 0; row < Sudoku::SIZE; ++row) {
+            for (column = 0; column < Sudoku::SIZE; ++column) {
+                if (_grid[row][column] == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool search() {
+        ++_nodes;
+        int row, column;
+        if (!findEmptyCell(row, column)) {
+            return true;
+        }
+        for (short value = 1; value <= Sudoku::SIZE; ++value) {
+            _grid[row][column] = value;
+            if (validCell(row, column) && search()) {
+                _moves.push_back(Sudoku::Move(row, column, value));
+                return true;
+            }
+        }
+        _grid[row][column] = 0;
+        return false;
+    }
+
+protected:
+    bool run(Sudoku& sudoku) {
+        if (!sudoku.valid()) {
+            return false;
+        }
+        for (int i = 0; i < Sudoku::SIZE; ++i) {
+            for (int j = 0; j < Sudoku::SIZE; ++j) {
+                _grid[i][j] = sudoku.get(i, j);
+            }
+        }
+        if (!search()) {
+            return false;
+        }
+        for (int i = 0; i < Sudoku::SIZE; ++i) {
+            for (int j = 0; j < Sudoku::SIZE; ++j) {
+                sudoku.set(i, j, _grid[i][j]);
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Lato delle caselle dei Sudoku di un file, ricavato dalla lunghezza
+ * della prima riga: 3 per 81 caratteri, 4 per 256, 5 per 625.
+ *
+ * @return Il lato, o 0 se il file non può essere aperto, è vuoto o la
+ *  lunghezza non corrisponde a una dimensione supportata.
+ */
+int corpusBox(const std::string& name) {
+    std::ifstream file(name.c_str());
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+        std::string::size_type length = line.size();
+        while (length > 0 && (line[length - 1] == ' ' ||
+                line[length - 1] == '\t' || line[length - 1] == '\r')) {
+            --length;
+        }
+        for (int box = 3; box <= 5; ++box) {
+            if (length == std::string::size_type(box * box * box * box)) {
+                return box;
+            }
+        }
+        return 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Legge i Sudoku di un file, saltando righe vuote e commenti.
+ *
+ * @return false se il file non può essere aperto o contiene righe non
+ *  valide.
+ */
+template <int B>
+bool readCorpus(const std::string& name,
+        std::vector<BasicSudoku<B> >& puzzles) {
+    std::ifstream file(name.c_str());
+    if (!file) {
+        std::cerr << name << ": impossibile aprire il file\n";
+        return false;
+    }
+
+    std::string line;
+    BasicSudoku<B> sudoku;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+        if (!sudoku.read(line)) {
+            std::cerr << name << ": riga non valida: " << line << '\n';
+            return false;
+        }
+        puzzles.push_back(sudoku);
+    }
+    return true;
+}
+
+/**
+ * @brief Risolve una copia di ogni Sudoku con solver e scrive la riga CSV.
+ */
+void solveBench(const std::string& corpus, const char* name,
+        SudokuSolver& solver, const std::vector<Sudoku>& puzzles) {
+    typedef std::chrono::steady_clock clock;
+
+    unsigned long solved = 0;
+    unsigned long long nodes = 0;
+    const clock::time_point start = clock::now();
+    for (std::vector<Sudoku>::size_type i = 0; i < puzzles.size(); ++i) {
+        Sudoku sudoku(puzzles[i]);
+        if (solver.solve(sudoku)) {
+            ++solved;
+        }
+        nodes += solver.nodes();
+    }
+    const double seconds = std::chrono::duration<double>(
+        clock::now() - start).count();
+
+    const double count = puzzles.empty() ? 1.0 : double(puzzles.size());
+    std::cout << corpus << ',' << name << ',' << puzzles.size() << ','
+              << solved << ',' << seconds << ','
+              << (seconds > 0 ? puzzles.size() / seconds : 0.0) << ','
+              << nodes << ',' << (nodes / count) << '\n';
+}
+
+/**
+ * @brief Risolve una copia di ogni Sudoku con BasicSudoku::solve e la
+ * propagazione indicata e scrive la riga CSV.
+ */
+template <int B>
+void sizeBench(const std::string& corpus, const char* name,
+        typename BasicSudoku<B>::Propagation propagation,
+        const std::vector<BasicSudoku<B> >& puzzles) {
+    typedef std::chrono::steady_clock clock;
+
+    unsigned long solved = 0;
+    unsigned long long nodes = 0;
+    const clock::time_point start = clock::now();
+    for (std::size_t i = 0; i < puzzles.size(); ++i) {
+        BasicSudoku<B> sudoku(puzzles[i]);
+        sudoku.setPropagation(propagation);
+        if (sudoku.solve()) {
+            ++solved;
+        }
+        nodes += sudoku.nodes();
+    }
+    const double seconds = std::chrono::duration<double>(
+        clock::now() - start).count();
+
+    const double count = puzzles.empty() ? 1.0 : double(puzzles.size());
+    std::cout << corpus << ',' << name << ',' << puzzles.size() << ','
+              << solved << ',' << seconds << ','
+              << (seconds > 0 ? puzzles.size() / seconds : 0.0) << ','
+              << nodes << ',' << (nodes / count) << '\n';
+}
+
+/**
+ * @brief Controlla l'unicità della soluzione di ogni Sudoku con un
+ * BasicSolutionCounter e scrive la riga CSV.
+ *
+ * @param threads Thread del contatore, 0 per usarne uno per core.
+ */
+template <int B>
+void uniqueBench(const std::string& corpus, const char* name,
+        unsigned int threads, const std::vector<BasicSudoku<B> >& puzzles) {
+    typedef std::chrono::steady_clock clock;
+
+    BasicSolutionCounter<B> counter(threads);
+    unsigned long unique = 0;
+    unsigned long long nodes = 0;
+    const clock::time_point start = clock::now();
+    for (std::size_t i = 0; i < puzzles.size(); ++i) {
+        if (counter.unique(puzzles[i])) {
+            ++unique;
+        }
+        nodes += counter.nodes();
+    }
+    const double seconds = std::chrono::duration<double>(
+        clock::now() - start).count();
+
+    const double count = puzzles.empty() ? 1.0 : double(puzzles.size());
+    std::cout << corpus << ',' << name << ',' << puzzles.size() << ','
+              << unique << ',' << seconds << ','
+              << (seconds > 0 ? puzzles.size() / seconds : 0.0) << ','
+              << nodes << ',' << (nodes / count) << '\n';
+}
+
+/**
+ * @brief Legge una raccolta di Sudoku di lato B · B, la risolve con i
+ * singoli e con i candidati bloccati e controlla l'unicità delle soluzioni.
+ *
+ * @return false se il file non può essere letto.
+ */
+template <int B>
+bool largeBench(const std::string& corpus) {
+    std::vector<BasicSudoku<B> > puzzles;
+    if (!readCorpus(corpus, puzzles)) {
+        return false;
+    }
+    sizeBench(corpus, "singles", BasicSudoku<B>::SINGLES, puzzles);
+    sizeBench(corpus, "locked", BasicSudoku<B>::LOCKED_CANDIDATES, puzzles);
+    uniqueBench(corpus, "unique", 1, puzzles);
+    uniqueBench(corpus, "unique_parallel", 0, puzzles);
+    return true;
+}
+
+/**
+ * @brief Risolve con batch il testo dei Sudoku e scrive la riga CSV.
+ */
+void batchBench(const std::string& corpus, SudokuBatch& batch,
+        const std::vector<Sudoku>& puzzles) {
+    std::string text;
+    for (std::vector<Sudoku>::size_type i = 0; i < puzzles.size(); ++i) {
+        text += puzzles[i].str();
+        text += '\n';
+    }
+    std::istringstream in(text);
+    std::ostream discard(nullptr);
+
+    const SudokuBatch::Stats stats = batch.run(in, discard, std::cerr,
+                                               corpus);
+    const double count = puzzles.empty() ? 1.0 : double(puzzles.size());
+    std::cout << corpus << ",batch," << stats.puzzles << ','
+              << stats.puzzles - stats.failed << ',' << stats.seconds << ','
+              << stats.puzzlesPerSecond() << ',' << stats.nodes << ','
+              << (stats.nodes / count) << '\n';
+}
+
+/**
+ * @brief Risolve una copia dei Sudoku con lanes e scrive la riga CSV.
+ */
+void lanesBench(const std::string& corpus, const char* name,
+        SudokuLanes& lanes, const std::vector<Sudoku>& puzzles) {
+    typedef std::chrono::steady_clock clock;
+
+    const clock::time_point start = clock::now();
+    std::vector<Sudoku> sudokus(puzzles);
+    const std::size_t solved = sudokus.empty()
+        ? 0 : lanes.solve(&sudokus[0], sudokus.size());
+    const double seconds = std::chrono::duration<double>(
+        clock::now() - start).count();
+
+    const double count = puzzles.empty() ? 1.0 : double(puzzles.size());
+    std::cout << corpus << ',' << name << ',' << puzzles.size() << ','
+              << solved << ',' << seconds << ','
+              << (seconds > 0 ? puzzles.size() / seconds : 0.0) << ','
+              << lanes.nodes() << ',' << (lanes.nodes() / count) << '\n';
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " file...\n";
+        return 2;
+    }
+
+    std::cout << "corpus,solver,puzzles,solved,seconds,puzzles_per_sec,"
+              << "nodes,nodes_per_puzzle\n";
+
+    BacktrackingSolver bitmask(Sudoku::NO_PROPAGATION);
+    BacktrackingSolver singles(Sudoku::SINGLES);
+    BacktrackingSolver locked(Sudoku::LOCKED_CANDIDATES);
+    DancingLinksSolver dlx;
+    ValidCellSolver valid_cell;
+    SudokuBatch batch;
+    const SudokuLanes::Isa isas[] = {
+        SudokuLanes::SCALAR, SudokuLanes::SSE2, SudokuLanes::AVX2
+    };
+    const char* isa_names[] = {"lanes_scalar", "lanes_sse2", "lanes_avx2"};
+
+    for (int i = 1; i < argc; ++i) {
+        const int box = corpusBox(argv[i]);
+        if (box == 4 || box == 5) {
+            if (!(box == 4 ? largeBench<4>(argv[i])
+                           : largeBench<5>(argv[i]))) {
+                return 2;
+            }
+            continue;
+        }
+
+        std::vector<Sudoku> puzzles;
+        if (!readCorpus(argv[i], puzzles)) {
+            return 2;
+        }
+        solveBench(argv[i], "bitmask", bitmask, puzzles);
+        solveBench(argv[i], "singles", singles, puzzles);
+        solveBench(argv[i], "locked", locked, puzzles);
+        solveBench(argv[i], "dlx", dlx, puzzles);
+        batchBench(argv[i], batch, puzzles);
+        for (int k = 0; k < 3; ++k) {
+            if (SudokuLanes::supported(isas[k])) {
+                SudokuLanes lanes(isas[k]);
+                lanesBench(argv[i], isa_names[k], lanes, puzzles);
+            }
+        }
+        uniqueBench(argv[i], "unique", 1, puzzles);
+        uniqueBench(argv[i], "unique_parallel", 0, puzzles);
+        solveBench(argv[i], "valid_cell", valid_cell, puzzles);
+    }
+
+    return 0;
+}
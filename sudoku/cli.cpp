@@ -0,0 +1,227 @@
+#include <iostream> // std::cin std::cout std::cerr
+#include <fstream> // std::ifstream
+#include <string> // std::string std::getline
+#include <chrono> // std::chrono::steady_clock
+#include <cstdlib> // std::strtoul
+
+#include "sudoku.h"
+#include "dancing_links.h"
+#include "batch.h"
+#include "counter.h"
+
+/**
+ * @file cli.cpp
+ * @brief Risolve da riga di comando i Sudoku letti da file o da stdin.
+ *
+ * Uso: sudoku.exe [-s] [-p] [-u] [-l | -n | -d] [-j thread] [file...]
+ *
+ * Ogni riga in input contiene un Sudoku nel formato di 81 caratteri di
+ * Sudoku::read; le righe vuote e quelle che iniziano con '#' vengono
+ * ignorate. Senza file, o con il file "-", legge lo standard input.
+ * Per ogni Sudoku scrive una riga con la soluzione; se la riga non è valida
+ * o il Sudoku non ha soluzioni scrive una riga vuota, così le righe in
+ * output corrispondono a quelle in input, e segnala l'errore su stderr.
+ * Con -s scrive su stderr il numero di Sudoku, i nodi visitati e il tempo.
+ * Con -p applica solo la propagazione dei vincoli (Sudoku::deduce) e scrive
+ * la griglia dedotta, con '.' per le celle rimaste vuote. -l aggiunge i
+ * candidati bloccati ai singoli, -n disattiva la propagazione, -d risolve
+ * con DancingLinksSolver.
+ * Con -j risolve con SudokuBatch su più thread (0 per usarne uno per core),
+ * con lo stesso output; -s aggiunge i Sudoku al secondo.
+ * Con -u scrive la soluzione solo se è unica, controllata contando le
+ * soluzioni fino a due; i Sudoku con più soluzioni sono trattati come
+ * quelli senza soluzione. Con -j, invece di SudokuBatch, il conteggio di
+ * ogni Sudoku viene diviso tra i thread con SolutionCounter.
+ * Termina con 1 se almeno un Sudoku non è stato risolto o, con -p, se le
+ * deduzioni mostrano che non ha soluzioni.
+ */
+
+/**
+ * @brief Opzioni della riga di comando.
+ */
+struct Options {
+    bool stats; ///< Statistiche su stderr
+    bool deduce_only; ///< Solo propagazione, senza ricerca
+    bool dancing_links; ///< DancingLinksSolver al posto del backtracking
+    bool unique; ///< Solo Sudoku con una soluzione
+    bool batch; ///< Risoluzione con SudokuBatch
+    unsigned int threads; ///< Thread di SudokuBatch o SolutionCounter
+    Sudoku::Propagation propagation; ///< Deduzioni usate
+
+    Options() : stats(false), deduce_only(false), dancing_links(false),
+            unique(false), batch(false), threads(0),
+            propagation(Sudoku::SINGLES) {}
+};
+
+/**
+ * @brief Contatori dell'esecuzione.
+ */
+struct Totals {
+    unsigned long puzzles; ///< Sudoku letti
+    unsigned long failed; ///< Sudoku non validi o senza soluzione
+    unsigned long long nodes; ///< Nodi visitati
+
+    Totals() : puzzles(0), failed(0), nodes(0) {}
+};
+
+/**
+ * @brief Risolve tutti i Sudoku letti da in.
+ *
+ * @param in Stream da leggere.
+ * @param name Nome dello stream nei messaggi di errore.
+ * @param options Opzioni della riga di comando.
+ * @param totals Contatori da aggiornare.
+ */
+void solveStream(std::istream& in, const std::string& name,
+        const Options& options, Totals& totals) {
+    BacktrackingSolver backtracking(options.propagation);
+    DancingLinksSolver dancing_links;
+    SudokuSolver& solver = options.dancing_links
+        ? static_cast<SudokuSolver&>(dancing_links) : backtracking;
+    SolutionCounter counter(options.batch ? options.threads : 1);
+    Sudoku sudoku;
+    sudoku.setPropagation(options.propagation);
+    std::string line;
+    unsigned long number = 0;
+
+    while (std::getline(in, line)) {
+        ++number;
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+
+        ++totals.puzzles;
+        if (!sudoku.read(line)) {
+            ++totals.failed;
+            std::cerr << name << ':' << number << ": riga non valida\n";
+            std::cout << '\n';
+            continue;
+        }
+
+        if (options.unique) {
+            const unsigned long long solutions = counter.count(sudoku, 2);
+            totals.nodes += counter.nodes();
+            if (solutions > 1) {
+                ++totals.failed;
+                std::cerr << name << ':' << number
+                          << ": più di una soluzione\n";
+                std::cout << '\n';
+                continue;
+            }
+        }
+
+        bool solved;
+        if (options.deduce_only) {
+            solved = sudoku.deduce();
+            totals.nodes += sudoku.nodes();
+        }
+        else {
+            solved = solver.solve(sudoku);
+            totals.nodes += solver.nodes();
+        }
+        if (!solved) {
+            ++totals.failed;
+            std::cerr << name << ':' << number << ": nessuna soluzione\n";
+            std::cout << '\n';
+            continue;
+        }
+        std::cout << sudoku.str() << '\n';
+    }
+}
+
+/**
+ * @brief Risolve tutti i Sudoku letti da in, con batch se richiesto dalle
+ * opzioni (salvo con -u) e altrimenti con solveStream.
+ *
+ * @param in Stream da leggere.
+ * @param name Nome dello stream nei messaggi di errore.
+ * @param options Opzioni della riga di comando.
+ * @param batch Pipeline configurata con le opzioni.
+ * @param totals Contatori da aggiornare.
+ */
+void solveInput(std::istream& in, const std::string& name,
+        const Options& options, SudokuBatch& batch, Totals& totals) {
+    if (!options.batch || options.unique) {
+        solveStream(in, name, options, totals);
+        return;
+    }
+    const SudokuBatch::Stats stats = batch.run(in, std::cout, std::cerr,
+                                               name);
+    totals.puzzles += stats.puzzles;
+    totals.failed += stats.failed;
+    totals.nodes += stats.nodes;
+}
+
+int main(int argc, char* argv[]) {
+    typedef std::chrono::steady_clock clock;
+
+    std::ios::sync_with_stdio(false);
+
+    Options options;
+    int first = 1;
+    for (; first < argc; ++first) {
+        const std::string option(argv[first]);
+        if (option == "-s") {
+            options.stats = true;
+        }
+        else if (option == "-p") {
+            options.deduce_only = true;
+        }
+        else if (option == "-l") {
+            options.propagation = Sudoku::LOCKED_CANDIDATES;
+        }
+        else if (option == "-n") {
+            options.propagation = Sudoku::NO_PROPAGATION;
+        }
+        else if (option == "-d") {
+            options.dancing_links = true;
+        }
+        else if (option == "-u") {
+            options.unique = true;
+        }
+        else if (option == "-j" && first + 1 < argc) {
+            options.batch = true;
+            options.threads = static_cast<unsigned int>(
+                std::strtoul(argv[++first], nullptr, 10));
+        }
+        else {
+            break;
+        }
+    }
+
+    SudokuBatch batch(options.threads);
+    batch.setPropagation(options.propagation);
+    batch.setDancingLinks(options.dancing_links);
+    batch.setDeduceOnly(options.deduce_only);
+
+    Totals totals;
+    const clock::time_point start = clock::now();
+
+    if (first == argc) {
+        solveInput(std::cin, "stdin", options, batch, totals);
+    }
+    for (int i = first; i < argc; ++i) {
+        const std::string name(argv[i]);
+        if (name == "-") {
+            solveInput(std::cin, "stdin", options, batch, totals);
+            continue;
+        }
+        std::ifstream file(name.c_str());
+        if (!file) {
+            std::cerr << name << ": impossibile aprire il file\n";
+            return 2;
+        }
+        solveInput(file, name, options, batch, totals);
+    }
+
+    if (options.stats) {
+        const double seconds = std::chrono::duration<double>(
+            clock::now() - start).count();
+        std::cerr << "sudoku: " << totals.puzzles << ", non risolti: "
+                  << totals.failed << ", nodi: " << totals.nodes
+                  << ", secondi: " << seconds << ", sudoku al secondo: "
+                  << (seconds > 0 ? totals.puzzles / seconds : 0.0) << '\n';
+    }
+
+    return totals.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,337 @@
+#ifndef counter_h
+#define counter_h
+
+#include <algorithm> // std::max std::min
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <functional> // std::cref
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex std::lock_guard
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include "sudoku.h"
+
+/**
+ * @file counter.h
+ * @brief Conteggio in parallelo delle soluzioni di un Sudoku.
+ */
+
+/**
+ * @brief Conta le soluzioni di un Sudoku di lato B · B dividendo l'albero
+ * della ricerca tra più thread.
+ *
+ * L'albero viene diviso con BasicSudoku::split alla profondità minima che
+ * dà almeno TASKS_PER_THREAD sottoproblemi per thread (fino a
+ * MAX_SPLIT_DEPTH scelte), e ogni sottoproblema viene contato con
+ * BasicSudoku::countSolutions. I sottoproblemi sono divisi in parti uguali
+ * tra le code dei thread: ogni thread prende i suoi dal fondo della propria
+ * coda e, quando è vuota, ruba dalla cima di quelle degli altri, così i
+ * thread che finiscono prima aiutano quelli con i rami più grandi.
+ *
+ * Le soluzioni trovate vengono sommate in un contatore atomico condiviso,
+ * aggiornato ogni INTERVAL nodi da un SudokuMonitor di ogni thread: quando
+ * il totale arriva al limite, o dopo cancel(), i monitor fermano le
+ * ricerche in corso e i thread non prendono altri sottoproblemi. Così un
+ * controllo di unicità (limit 2) finisce appena due rami qualsiasi hanno
+ * trovato una soluzione ciascuno.
+ *
+ * @param B Lato di una casella, come in BasicSudoku.
+ */
+template <int B>
+class BasicSolutionCounter {
+public:
+    typedef BasicSudoku<B> Puzzle; ///< Sudoku contati
+
+    enum {
+        TASKS_PER_THREAD = 8, ///< Sottoproblemi cercati per ogni thread
+        MAX_SPLIT_DEPTH = 8, ///< Profondità massima della divisione
+        INTERVAL = 256 ///< Nodi tra due controlli del contatore condiviso
+    };
+
+private:
+
+    /**
+     * @brief Coda dei sottoproblemi di un thread, come intervallo di
+     * indici in _tasks.
+     */
+    struct Queue {
+        std::mutex mutex; ///< Protegge front e back
+        std::size_t front; ///< Primo sottoproblema, preso da chi ruba
+        std::size_t back; ///< Dopo l'ultimo, preso dal proprietario
+    };
+
+    /**
+     * @brief Osservatore della ricerca di un thread: pubblica le soluzioni
+     * trovate e ferma la ricerca quando il conteggio è finito.
+     */
+    class Monitor : public SudokuMonitor {
+        BasicSolutionCounter& _counter; ///< Conteggio in corso
+        const Puzzle& _sudoku; ///< Sudoku del thread
+        unsigned long long _published; ///< Soluzioni già sommate
+
+    public:
+        Monitor(BasicSolutionCounter& counter, const Puzzle& sudoku) :
+                _counter(counter), _sudoku(sudoku), _published(0) {}
+
+        /**
+         * @brief Somma al contatore condiviso le soluzioni trovate dopo
+         * l'ultima chiamata.
+         */
+        void publish() {
+            _counter._found += _sudoku.solutions() - _published;
+            _published = _sudoku.solutions();
+        }
+
+        /**
+         * @brief Prepara il monitor per un nuovo sottoproblema.
+         */
+        void reset() {
+            _published = 0;
+        }
+
+        bool progress(unsigned long long, int) {
+            publish();
+            return !_counter.stopping();
+        }
+    };
+
+    unsigned int _threads; ///< Thread di lavoro
+    unsigned long long _limit; ///< Limite del conteggio in corso
+    std::vector<std::string> _tasks; ///< Sottoproblemi, nel formato di str
+    std::unique_ptr<Queue[]> _queues; ///< Una coda per thread
+    std::atomic<unsigned long long> _found; ///< Soluzioni trovate
+    std::atomic<unsigned long long> _nodes; ///< Nodi visitati
+    std::atomic<unsigned long> _steals; ///< Sottoproblemi rubati
+    std::atomic<bool> _cancelled; ///< Richiesta di cancel()
+    bool _interrupted; ///< Ultimo conteggio fermato da cancel()
+
+    BasicSolutionCounter(const BasicSolutionCounter&); // Non copiabile
+    BasicSolutionCounter& operator=(const BasicSolutionCounter&);
+
+    /**
+     * @brief Controlla se le ricerche in corso devono fermarsi.
+     */
+    bool stopping() const {
+        return _cancelled || _found >= _limit;
+    }
+
+    /**
+     * @brief Prende un sottoproblema per il thread t: il più recente della
+     * sua coda o il più vecchio di un'altra.
+     *
+     * @param index Indice in _tasks del sottoproblema, in output.
+     * @return false se tutte le code sono vuote.
+     */
+    bool take(unsigned int t, std::size_t& index) {
+        {
+            Queue& own = _queues[t];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.front < own.back) {
+                index = --own.back;
+                return true;
+            }
+        }
+        for (unsigned int k = 1; k < _threads; ++k) {
+            Queue& other = _queues[(t + k) % _threads];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (other.front < other.back) {
+                index = other.front++;
+                ++_steals;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Ciclo di un thread di lavoro: conta le soluzioni dei
+     * sottoproblemi finché ce ne sono e il conteggio non è finito.
+     *
+     * @param sudoku Sudoku da contare, per la propagazione scelta.
+     */
+    void work(unsigned int t, const Puzzle& sudoku) {
+        Puzzle task(sudoku);
+        Monitor monitor(*this, task);
+        std::size_t index;
+        while (!stopping() && take(t, index)) {
+            task.read(_tasks[index]);
+            monitor.reset();
+            task.countSolutions(_limit, monitor, INTERVAL);
+            monitor.publish();
+            _nodes += task.nodes();
+        }
+    }
+
+    /**
+     * @brief Divide la ricerca di sudoku in _tasks.
+     *
+     * @return Le soluzioni completate prima della divisione.
+     */
+    unsigned long long split(const Puzzle& sudoku) {
+        Puzzle root(sudoku);
+        const std::size_t wanted = std::size_t(TASKS_PER_THREAD) * _threads;
+        unsigned long long found = 0;
+        for (int depth = 1; depth <= MAX_SPLIT_DEPTH; ++depth) {
+            _tasks.clear();
+            found = root.split(depth, _tasks);
+            _nodes += root.nodes();
+            if (_tasks.size() >= wanted || _tasks.empty()) {
+                break;
+            }
+        }
+        return found;
+    }
+
+public:
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param threads Thread di lavoro, 0 per usarne uno per core.
+     */
+    explicit BasicSolutionCounter(unsigned int threads = 0) :
+            _threads(threads), _limit(0), _found(0), _nodes(0), _steals(0),
+            _cancelled(false), _interrupted(false) {
+        if (_threads == 0) {
+            _threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    /**
+     * @brief Ritorna il numero di thread di lavoro.
+     */
+    unsigned int threads() const {
+        return _threads;
+    }
+
+    /**
+     * @brief Conta le soluzioni di sudoku, fermandosi a limit, come
+     * Puzzle::countSolutions.
+     *
+     * sudoku non viene modificato; i sottoproblemi usano la sua
+     * propagazione. Con un solo thread la ricerca non viene divisa.
+     * Se cancel() è stato chiamato dopo l'ultimo reset(), anche prima
+     * dell'inizio, il conteggio si ferma entro INTERVAL nodi.
+     *
+     * @return Il numero di soluzioni se è minore di limit, altrimenti
+     *  limit; 0 se la griglia non è valida. Dopo cancel() le soluzioni
+     *  trovate fino a quel momento.
+     * @pre limit > 0
+     * @throw std::system_error se un thread non può essere creato
+     */
+    unsigned long long count(const Puzzle& sudoku,
+            unsigned long long limit) {
+        assert(limit > 0);
+        _limit = limit;
+        _found = 0;
+        _nodes = 0;
+        _steals = 0;
+        _tasks.clear();
+
+        if (_threads == 1) {
+            Puzzle task(sudoku);
+            Monitor monitor(*this, task);
+            task.countSolutions(limit, monitor, INTERVAL);
+            monitor.publish();
+            _nodes += task.nodes();
+        }
+        else {
+            _found = split(sudoku);
+            _queues.reset(new Queue[_threads]);
+            for (unsigned int t = 0; t < _threads; ++t) {
+                _queues[t].front = _tasks.size() * t / _threads;
+                _queues[t].back = _tasks.size() * (t + 1) / _threads;
+            }
+
+            std::vector<std::thread> workers;
+            try {
+                for (unsigned int t = 0; t < _threads; ++t) {
+                    workers.push_back(std::thread(
+                        &BasicSolutionCounter::work, this, t,
+                        std::cref(sudoku)));
+                }
+            } catch(...) {
+                _cancelled = true;
+                for (std::size_t t = 0; t < workers.size(); ++t) {
+                    workers[t].join();
+                }
+                throw;
+            }
+            for (std::size_t t = 0; t < workers.size(); ++t) {
+                workers[t].join();
+            }
+        }
+
+        _interrupted = _cancelled && _found < limit;
+        return std::min<unsigned long long>(_found, limit);
+    }
+
+    /**
+     * @brief Controlla se sudoku ha una e una sola soluzione.
+     */
+    bool unique(const Puzzle& sudoku) {
+        return count(sudoku, 2) == 1;
+    }
+
+    /**
+     * @brief Ferma il conteggio in corso; può essere chiamato da ogni
+     * thread.
+     *
+     * Le ricerche si fermano al successivo controllo, entro INTERVAL nodi.
+     * La richiesta resta valida fino a reset(), quindi se arriva prima
+     * che count() inizi ferma quel conteggio invece di andare persa.
+     */
+    void cancel() {
+        _cancelled = true;
+    }
+
+    /**
+     * @brief Annulla una richiesta di cancel(), per i conteggi successivi.
+     *
+     * @pre Nessun conteggio in corso.
+     */
+    void reset() {
+        _cancelled = false;
+    }
+
+    /**
+     * @brief Controlla se l'ultimo conteggio è stato fermato da cancel()
+     * prima di arrivare al limite o di esaurire la ricerca.
+     */
+    bool interrupted() const {
+        return _interrupted;
+    }
+
+    /**
+     * @brief Ritorna i nodi visitati dall'ultimo conteggio, compresi quelli
+     * della divisione.
+     */
+    unsigned long long nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Ritorna i sottoproblemi dell'ultimo conteggio, 0 se la ricerca
+     * non è stata divisa.
+     */
+    std::size_t tasks() const {
+        return _tasks.size();
+    }
+
+    /**
+     * @brief Ritorna i sottoproblemi rubati dalla coda di un altro thread
+     * nell'ultimo conteggio.
+     */
+    unsigned long steals() const {
+        return _steals;
+    }
+};
+
+/**
+ * @brief Conteggio in parallelo delle soluzioni del Sudoku classico 9x9.
+ */
+typedef BasicSolutionCounter<3> SolutionCounter;
+
+#endif //counter_h
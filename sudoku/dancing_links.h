@@ -0,0 +1,267 @@
+#ifndef dancing_links_h
+#define dancing_links_h
+
+#include "sudoku.h"
+
+/**
+ * @file dancing_links.h
+ * @brief Solver di Sudoku con l'algoritmo X di Knuth e i Dancing Links.
+ */
+
+/**
+ * @brief Solver che riduce il Sudoku a un problema di copertura esatta.
+ *
+ * Ogni riga della matrice è una scelta (cella, cifra) e copre quattro
+ * vincoli, le colonne: la cella è piena, la riga, la colonna e la casella
+ * contengono la cifra. Una soluzione è un insieme di righe che copre ogni
+ * colonna esattamente una volta. Le righe e le colonne non ancora escluse
+ * sono liste circolari doppiamente collegate: coprire una colonna toglie
+ * dalle liste le righe incompatibili, e scoprirla le rimette al loro posto
+ * con gli stessi collegamenti, in ordine inverso.
+ *
+ * Tutti i nodi stanno in un pool di dimensione fissa collegato una volta
+ * alla costruzione, con indici a 16 bit al posto dei puntatori. Per ogni
+ * Sudoku vengono coperte le righe delle celle piene, la ricerca sceglie
+ * sempre la colonna con meno righe e alla fine tutto viene scoperto, così
+ * la matrice torna com'era senza essere ricostruita e nessun passo alloca
+ * memoria.
+ *
+ * Le mosse sono le righe scelte: una colonna con una sola riga rimasta è
+ * una scelta obbligata e viene registrata come singolo nudo (vincolo di
+ * cella) o nascosto (vincolo di riga, colonna o casella), le altre come
+ * scelte della ricerca.
+ */
+class DancingLinksSolver : public SudokuSolver {
+    enum {
+        SIZE = Sudoku::SIZE,
+        CONSTRAINTS = 4 * Sudoku::CELLS, ///< Colonne della matrice
+        CHOICES = SIZE * Sudoku::CELLS, ///< Righe della matrice
+        FIRST_NODE = CONSTRAINTS + 1, ///< Primo nodo di una riga
+        NODES = FIRST_NODE + 4 * CHOICES ///< Radice, colonne e righe
+    };
+
+    typedef unsigned short node; ///< Indice di un nodo nel pool
+
+    // Il nodo 0 è la radice, da 1 a CONSTRAINTS le intestazioni delle
+    // colonne, poi quattro nodi per ogni riga in ordine di scelta
+    node _left[NODES]; ///< Nodo precedente nella riga
+    node _right[NODES]; ///< Nodo successivo nella riga
+    node _up[NODES]; ///< Nodo precedente nella colonna
+    node _down[NODES]; ///< Nodo successivo nella colonna
+    node _column[NODES]; ///< Intestazione della colonna del nodo
+    unsigned short _count[CONSTRAINTS + 1]; ///< Righe rimaste per colonna
+
+    node _chosen[Sudoku::CELLS]; ///< Nodi delle righe scelte
+    unsigned char _kinds[Sudoku::CELLS]; ///< Sudoku::MoveKind delle scelte
+    int _depth; ///< Righe scelte finora
+
+    /**
+     * @brief Primo nodo della riga che sceglie digit (da 0) nella cella.
+     */
+    static node choiceNode(int cell, int digit) {
+        return static_cast<node>(FIRST_NODE + 4 * (cell * SIZE + digit));
+    }
+
+    /**
+     * @brief Scelta (cella * 9 + cifra da 0) della riga del nodo.
+     */
+    static int choiceOf(node n) {
+        return (n - FIRST_NODE) / 4;
+    }
+
+    /**
+     * @brief Toglie la colonna c e le righe che la coprono.
+     */
+    void cover(node c) {
+        _right[_left[c]] = _right[c];
+        _left[_right[c]] = _left[c];
+        for (node i = _down[c]; i != c; i = _down[i]) {
+            for (node j = _right[i]; j != i; j = _right[j]) {
+                _down[_up[j]] = _down[j];
+                _up[_down[j]] = _up[j];
+                --_count[_column[j]];
+            }
+        }
+    }
+
+    /**
+     * @brief Annulla cover(c).
+     */
+    void uncover(node c) {
+        for (node i = _up[c]; i != c; i = _up[i]) {
+            for (node j = _left[i]; j != i; j = _left[j]) {
+                ++_count[_column[j]];
+                _down[_up[j]] = j;
+                _up[_down[j]] = j;
+            }
+        }
+        _right[_left[c]] = c;
+        _left[_right[c]] = c;
+    }
+
+    /**
+     * @brief Sceglie la riga del nodo r coprendo le altre sue colonne.
+     */
+    void select(node r) {
+        for (node j = _right[r]; j != r; j = _right[j]) {
+            cover(_column[j]);
+        }
+    }
+
+    /**
+     * @brief Annulla select(r).
+     */
+    void unselect(node r) {
+        for (node j = _left[r]; j != r; j = _left[j]) {
+            uncover(_column[j]);
+        }
+    }
+
+    /**
+     * @brief Controlla che la colonna c non sia già coperta.
+     */
+    bool uncovered(node c) const {
+        return _right[_left[c]] == c;
+    }
+
+    /**
+     * @brief Algoritmo X sulla colonna con meno righe.
+     *
+     * Ritorna dopo aver scoperto tutto ciò che ha coperto, anche in caso
+     * di successo: le righe scelte restano in _chosen.
+     */
+    bool search() {
+        ++_nodes;
+
+        if (_right[0] == 0) {
+            return true;
+        }
+
+        node best = _right[0];
+        for (node c = _right[best]; c != 0 && _count[best] > 1;
+                c = _right[c]) {
+            if (_count[c] < _count[best]) {
+                best = c;
+            }
+        }
+        if (_count[best] == 0) {
+            return false;
+        }
+
+        Sudoku::MoveKind kind = Sudoku::GUESS;
+        if (_count[best] == 1) {
+            kind = best <= Sudoku::CELLS ? Sudoku::NAKED_SINGLE
+                                         : Sudoku::HIDDEN_SINGLE;
+        }
+
+        bool solved = false;
+        cover(best);
+        for (node r = _down[best]; r != best && !solved; r = _down[r]) {
+            _chosen[_depth] = r;
+            _kinds[_depth] = static_cast<unsigned char>(kind);
+            ++_depth;
+            select(r);
+            solved = search();
+            unselect(r);
+            if (!solved) {
+                --_depth;
+            }
+        }
+        uncover(best);
+        return solved;
+    }
+
+protected:
+    bool run(Sudoku& sudoku) {
+        // Righe delle celle piene, fermandosi al primo conflitto
+        node givens[Sudoku::CELLS];
+        int given_count = 0;
+        bool valid = true;
+        for (int cell = 0; cell < Sudoku::CELLS && valid; ++cell) {
+            const short value = sudoku.get(cell / SIZE, cell % SIZE);
+            if (value == 0) {
+                continue;
+            }
+            const node r = choiceNode(cell, value - 1);
+            node j = r;
+            do {
+                valid = uncovered(_column[j]);
+                j = _right[j];
+            } while (valid && j != r);
+            if (valid) {
+                cover(_column[r]);
+                select(r);
+                givens[given_count++] = r;
+            }
+        }
+
+        _depth = 0;
+        const bool solved = valid && search();
+
+        for (int k = given_count; k-- > 0;) {
+            unselect(givens[k]);
+            uncover(_column[givens[k]]);
+        }
+
+        if (!solved) {
+            return false;
+        }
+        for (int k = _depth; k-- > 0;) {
+            const int choice = choiceOf(_chosen[k]);
+            const int cell = choice / SIZE;
+            const short value = static_cast<short>(choice % SIZE + 1);
+            sudoku.set(cell / SIZE, cell % SIZE, value);
+            _moves.push_back(Sudoku::Move(
+                cell / SIZE, cell % SIZE, value,
+                static_cast<Sudoku::MoveKind>(_kinds[k])));
+        }
+        return true;
+    }
+
+public:
+
+    /**
+     * @brief Costruttore, collega la matrice completa nel pool.
+     */
+    DancingLinksSolver() : _depth(0) {
+        // Radice e intestazioni in un'unica lista circolare
+        for (int c = 0; c <= CONSTRAINTS; ++c) {
+            _left[c] = static_cast<node>(c == 0 ? CONSTRAINTS : c - 1);
+            _right[c] = static_cast<node>(c == CONSTRAINTS ? 0 : c + 1);
+            _up[c] = _down[c] = _column[c] = static_cast<node>(c);
+            _count[c] = 0;
+        }
+
+        // Vincolo della cella, poi uno per ogni sua unità: "l'unità u
+        // contiene digit" è la colonna 1 + CELLS + u * SIZE + digit
+        const int cells = Sudoku::CELLS;
+        for (int cell = 0; cell < cells; ++cell) {
+            const unsigned char* units = Sudoku::CELL_UNITS.units[cell];
+            for (int digit = 0; digit < SIZE; ++digit) {
+                const int columns[4] = {
+                    1 + cell,
+                    1 + cells + units[0] * SIZE + digit,
+                    1 + cells + units[1] * SIZE + digit,
+                    1 + cells + units[2] * SIZE + digit
+                };
+                const node first = choiceNode(cell, digit);
+                for (int k = 0; k < 4; ++k) {
+                    const node n = static_cast<node>(first + k);
+                    const node c = static_cast<node>(columns[k]);
+                    _left[n] = static_cast<node>(first + (k + 3) % 4);
+                    _right[n] = static_cast<node>(first + (k + 1) % 4);
+
+                    // In fondo alla colonna
+                    _column[n] = c;
+                    _up[n] = _up[c];
+                    _down[n] = c;
+                    _down[_up[c]] = n;
+                    _up[c] = n;
+                    ++_count[c];
+                }
+            }
+        }
+    }
+};
+
+#endif //dancing_links_h
@@ -0,0 +1,314 @@
+#ifndef lanes_h
+#define lanes_h
+
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+
+#include "sudoku.h"
+
+/**
+ * @file lanes.h
+ * @brief Propagazione dei vincoli su più Sudoku contemporaneamente, con
+ * istruzioni vettoriali.
+ */
+
+/**
+ * @brief Risolve gruppi di LANES Sudoku applicando a tutti insieme la
+ * propagazione dei singoli, una cifra di ogni Sudoku per elemento di un
+ * registro vettoriale.
+ *
+ * Le maschere dei candidati sono memorizzate per cella e poi per Sudoku
+ * (_cells[cella][sudoku]), così i candidati di una cella in LANES Sudoku
+ * diversi sono contigui e un'operazione vettoriale li aggiorna tutti: 16
+ * maschere a 16 bit per registro con AVX2, 8 con SSE2, una con la versione
+ * scalare. Ogni passata scorre le 27 unità senza salti dipendenti dai dati:
+ * le cifre delle celle con un solo candidato vengono tolte dalle altre celle
+ * dell'unità (singoli nudi) e una cella che è l'unica dell'unità ad avere
+ * una cifra viene ridotta a quella cifra (singoli nascosti). Le passate si
+ * ripetono finché una maschera del gruppo cambia; un Sudoku con una cella
+ * senza candidati, una cifra senza celle o una cifra ripetuta in un'unità
+ * viene segnato come senza soluzione.
+ *
+ * I Sudoku completati dalla propagazione vengono scritti direttamente, gli
+ * altri ricevono le celle dedotte e vengono finiti con Sudoku::solve. Il
+ * kernel è un unico template sui vector extension di GCC e Clang; la
+ * versione AVX2 viene compilata con l'attributo target e scelta a runtime
+ * solo se il processore la supporta.
+ */
+class SudokuLanes {
+public:
+    enum {
+        LANES = 16 ///< Sudoku elaborati insieme
+    };
+
+    /**
+     * @brief Versione del kernel.
+     */
+    enum Isa {
+        SCALAR, ///< Un Sudoku per operazione
+        SSE2, ///< 8 Sudoku per operazione
+        AVX2 ///< 16 Sudoku per operazione
+    };
+
+private:
+    typedef unsigned short lane_mask; ///< Maschera dei candidati
+    typedef lane_mask scalar_lanes __attribute__((vector_size(2)));
+    typedef lane_mask sse2_lanes __attribute__((vector_size(16)));
+    typedef lane_mask avx2_lanes __attribute__((vector_size(32)));
+
+    enum {
+        SIZE = Sudoku::SIZE,
+        CELLS = Sudoku::CELLS,
+        UNITS = Sudoku::UNITS
+    };
+
+    alignas(32) lane_mask _cells[CELLS][LANES]; ///< Candidati per Sudoku
+    lane_mask _failed[LANES]; ///< Diverso da 0 se senza soluzione
+    Isa _isa; ///< Kernel usato
+    unsigned long long _nodes; ///< Nodi delle ricerche scalari
+    unsigned long _searched; ///< Sudoku finiti con Sudoku::solve
+
+    /**
+     * @brief Applica la propagazione dei singoli ai LANES Sudoku di cells,
+     * sizeof(V) / 2 alla volta.
+     *
+     * @param V Vettore di maschere dei vector extension.
+     */
+    template <typename V>
+    static void propagateLanes(lane_mask (*cells)[LANES],
+            const unsigned char (*units)[SIZE], lane_mask* failed) {
+        const int WIDTH = sizeof(V) / sizeof(lane_mask);
+        const V zero = {};
+        const V one = zero + 1;
+        const V all = zero + static_cast<lane_mask>(Sudoku::ALL_DIGITS);
+
+        for (int lane = 0; lane < LANES; lane += WIDTH) {
+            V dead = zero;
+            bool changing = true;
+            while (changing) {
+                V changed = zero;
+                for (int u = 0; u < UNITS; ++u) {
+                    V fixed = zero;
+                    V repeated = zero;
+                    V once = zero;
+                    V twice = zero;
+                    for (int k = 0; k < SIZE; ++k) {
+                        V c;
+                        std::memcpy(&c, cells[units[u][k]] + lane, sizeof c);
+                        const V single = (V)((c & (c - one)) == zero);
+                        repeated |= fixed & c & single;
+                        fixed |= c & single;
+                        twice |= once & c;
+                        once |= c;
+                    }
+                    const V unique = once & ~twice;
+                    dead |= repeated | (once ^ all);
+
+                    for (int k = 0; k < SIZE; ++k) {
+                        V c;
+                        std::memcpy(&c, cells[units[u][k]] + lane, sizeof c);
+                        const V single = (V)((c & (c - one)) == zero);
+                        V n = c & (single | ~fixed);
+                        const V hidden = n & unique;
+                        const V is_hidden = (V)(hidden != zero);
+                        n = (hidden & is_hidden) | (n & ~is_hidden);
+                        dead |= (V)(n == zero) |
+                                (V)((hidden & (hidden - one)) != zero);
+                        changed |= n ^ c;
+                        std::memcpy(cells[units[u][k]] + lane, &n, sizeof n);
+                    }
+                }
+
+                changed &= ~dead;
+                changing = false;
+                for (int i = 0; i < WIDTH; ++i) {
+                    changing = changing || changed[i] != 0;
+                }
+            }
+            std::memcpy(failed + lane, &dead, sizeof dead);
+        }
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    /**
+     * @brief propagateLanes con AVX2: flatten espande il template dentro
+     * questa funzione, compilata con AVX2.
+     */
+    __attribute__((target("avx2"), flatten))
+    static void propagateAvx2(lane_mask (*cells)[LANES],
+            const unsigned char (*units)[SIZE], lane_mask* failed) {
+        propagateLanes<avx2_lanes>(cells, units, failed);
+    }
+#endif
+
+    /**
+     * @brief Propagazione con il kernel scelto.
+     */
+    void propagate() {
+        switch (_isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        case AVX2:
+            propagateAvx2(_cells, Sudoku::UNIT_CELLS.cells, _failed);
+            break;
+#endif
+        case SSE2:
+            propagateLanes<sse2_lanes>(_cells, Sudoku::UNIT_CELLS.cells,
+                                       _failed);
+            break;
+        default:
+            propagateLanes<scalar_lanes>(_cells, Sudoku::UNIT_CELLS.cells,
+                                         _failed);
+            break;
+        }
+    }
+
+    /**
+     * @brief Copia in _cells i Sudoku da first a first + count; i LANES -
+     * count Sudoku rimanenti sono vuoti.
+     */
+    void load(const Sudoku* first, std::size_t count) {
+        for (int cell = 0; cell < CELLS; ++cell) {
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                const short value = lane < count
+                    ? first[lane].get(cell / SIZE, cell % SIZE) : 0;
+                _cells[cell][lane] = static_cast<lane_mask>(
+                    value == 0 ? Sudoku::ALL_DIGITS : 1 << (value - 1));
+            }
+        }
+    }
+
+    /**
+     * @brief Scrive in sudoku le celle dedotte nel Sudoku lane e, se non
+     * bastano, lo finisce con Sudoku::solve.
+     *
+     * @return true se sudoku è stato risolto; altrimenti resta invariato.
+     */
+    bool store(int lane, Sudoku& sudoku) {
+        if (_failed[lane] != 0) {
+            return false;
+        }
+
+        unsigned char deduced[CELLS];
+        int deduced_count = 0;
+        bool complete = true;
+        for (int cell = 0; cell < CELLS; ++cell) {
+            const lane_mask m = _cells[cell][lane];
+            if ((m & (m - 1)) != 0) {
+                complete = false;
+            }
+            else if (sudoku.get(cell / SIZE, cell % SIZE) == 0) {
+                sudoku.set(cell / SIZE, cell % SIZE,
+                           static_cast<short>(lowestBit(m) + 1));
+                deduced[deduced_count++] = static_cast<unsigned char>(cell);
+            }
+        }
+        if (complete) {
+            return true;
+        }
+
+        ++_searched;
+        const bool solved = sudoku.solve();
+        _nodes += sudoku.nodes();
+        if (!solved) {
+            for (int k = 0; k < deduced_count; ++k) {
+                sudoku.set(deduced[k] / SIZE, deduced[k] % SIZE, 0);
+            }
+        }
+        return solved;
+    }
+
+public:
+
+    /**
+     * @brief Controlla se il kernel isa può essere usato su questo
+     * processore.
+     */
+    static bool supported(Isa isa) {
+        switch (isa) {
+        case AVX2:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        case SSE2:
+#if defined(__SSE2__)
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return true;
+        }
+    }
+
+    /**
+     * @brief Ritorna il kernel più largo supportato dal processore.
+     */
+    static Isa bestIsa() {
+        return supported(AVX2) ? AVX2 : supported(SSE2) ? SSE2 : SCALAR;
+    }
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param isa Kernel da usare.
+     * @pre supported(isa)
+     */
+    explicit SudokuLanes(Isa isa = bestIsa()) : _cells(), _failed(),
+            _isa(isa), _nodes(0), _searched(0) {
+        assert(supported(isa));
+    }
+
+    /**
+     * @brief Ritorna il kernel usato.
+     */
+    Isa isa() const {
+        return _isa;
+    }
+
+    /**
+     * @brief Risolve count Sudoku, LANES alla volta.
+     *
+     * I Sudoku risolti vengono riempiti, gli altri (griglie non valide o
+     * senza soluzione) restano invariati. Le mosse dei Sudoku completati
+     * dalla propagazione non vengono registrate.
+     *
+     * @return Il numero di Sudoku risolti.
+     */
+    std::size_t solve(Sudoku* sudokus, std::size_t count) {
+        _nodes = 0;
+        _searched = 0;
+        std::size_t solved = 0;
+        for (std::size_t first = 0; first < count; first += LANES) {
+            const std::size_t n = count - first < std::size_t(LANES)
+                ? count - first : std::size_t(LANES);
+            load(sudokus + first, n);
+            propagate();
+            for (std::size_t lane = 0; lane < n; ++lane) {
+                if (store(static_cast<int>(lane), sudokus[first + lane])) {
+                    ++solved;
+                }
+            }
+        }
+        return solved;
+    }
+
+    /**
+     * @brief Ritorna i nodi visitati da Sudoku::solve nell'ultima chiamata
+     * a solve.
+     */
+    unsigned long long nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Ritorna i Sudoku che nell'ultima chiamata a solve non sono
+     * stati completati dalla propagazione.
+     */
+    unsigned long searched() const {
+        return _searched;
+    }
+};
+
+#endif //lanes_h
@@ -0,0 +1,1240 @@
+#ifndef sudoku_h
+#define sudoku_h
+
+#include <cassert> // assert
+#include <chrono> // std::chrono::steady_clock
+#include <cstdint> // std::uint16_t std::uint32_t
+#include <string> // std::string
+#include <type_traits> // std::conditional
+#include <utility> // std::swap
+#include <vector> // std::vector
+
+#include "../bits.h" // bitCount lowestBit
+
+/**
+ * @file sudoku.h
+ * @brief Solver di Sudoku indipendente da Qt.
+ *
+ * È il motore usato sia dall'applicazione Qt sia dalla riga di comando e dal
+ * benchmark, che non hanno interfaccia grafica. Il Sudoku classico 9x9 è
+ * Sudoku; BasicSudoku<4> e BasicSudoku<5> sono le varianti 16x16 e 25x25.
+ */
+
+/**
+ * @brief Osservatore della ricerca di Sudoku::solve.
+ *
+ * Permette a chi esegue la ricerca in un altro thread di mostrarne
+ * l'avanzamento e di interromperla, senza che il solver dipenda da Qt.
+ */
+class SudokuMonitor {
+public:
+    virtual ~SudokuMonitor() {}
+
+    /**
+     * @brief Chiamato dalla ricerca a intervalli regolari di nodi.
+     *
+     * @param nodes Nodi visitati finora.
+     * @param depth Scelte nel ramo corrente.
+     * @return false per interrompere la ricerca.
+     */
+    virtual bool progress(unsigned long long nodes, int depth) = 0;
+};
+
+/**
+ * @brief Sequenza di interi 0, 1, ..., usata per generare tabelle
+ * constexpr con l'espansione di un parameter pack.
+ */
+template <int... I>
+struct IndexList {};
+
+/**
+ * @brief Raddoppia la sequenza 0..N-1 in 0..2N-1, aggiungendo 2N se Odd.
+ */
+template <typename L, int N, bool Odd>
+struct DoubledList;
+
+template <int... I, int N>
+struct DoubledList<IndexList<I...>, N, false> {
+    typedef IndexList<I..., (I + N)...> type;
+};
+
+template <int... I, int N>
+struct DoubledList<IndexList<I...>, N, true> {
+    typedef IndexList<I..., (I + N)..., 2 * N> type;
+};
+
+/**
+ * @brief IndexList da 0 a N - 1.
+ *
+ * La sequenza viene costruita raddoppiando, con log2(N) istanziazioni:
+ * una ricorsione lineare supererebbe il limite di profondità dei template
+ * con le tabelle del 25x25.
+ */
+template <int N>
+struct IndexRange {
+    typedef typename DoubledList<typename IndexRange<N / 2>::type, N / 2,
+                                 N % 2 == 1>::type type;
+};
+
+template <>
+struct IndexRange<0> {
+    typedef IndexList<> type;
+};
+
+/**
+ * @brief Griglia di Sudoku di lato BOX · BOX con il relativo solver.
+ *
+ * Le celle valgono da 1 a SIZE, 0 indica una cella vuota. Il solver riempie
+ * le celle vuote con una ricerca in profondità e registra le mosse che
+ * portano alla soluzione, così un'interfaccia può mostrarle una alla volta.
+ *
+ * Durante la ricerca ogni riga, colonna e casella ha una maschera di SIZE
+ * bit delle cifre già usate (bit d - 1 per la cifra d), aggiornata a ogni
+ * inserimento e annullamento: i candidati di una cella si ottengono con un
+ * AND-NOT delle tre maschere invece di rileggere tutta riga, colonna e
+ * casella per ogni cifra.
+ * A ogni passo la ricerca sceglie la cella vuota con meno candidati e
+ * torna indietro subito se una cella non ne ha nessuno.
+ *
+ * Prima di ogni scelta la propagazione dei vincoli riempie le celle che non
+ * hanno alternative (singoli nudi e nascosti) e, se attivati, toglie i
+ * candidati esclusi dai candidati bloccati, finché la griglia non cambia
+ * più. Le celle riempite e i candidati tolti durante un ramo vengono
+ * annullati quando la ricerca torna indietro.
+ *
+ * Il lato è un parametro del template: dimensioni delle tabelle, tipo delle
+ * maschere e geometria di righe, colonne e caselle sono costanti di
+ * compilazione, quindi ogni dimensione ha il suo codice specializzato.
+ *
+ * @param B Lato di una casella, da 2 a 5.
+ */
+template <int B>
+class BasicSudoku {
+    static_assert(B >= 2 && B <= 5, "Le maschere hanno al massimo 32 bit");
+
+public:
+    enum {
+        SIZE = B * B, ///< Righe e colonne della griglia
+        BOX = B, ///< Lato di una casella
+        CELLS = SIZE * SIZE, ///< Celle della griglia
+        UNITS = 3 * SIZE ///< Righe, colonne e caselle
+    };
+
+    /**
+     * @brief Origine di una mossa.
+     */
+    enum MoveKind {
+        GUESS, ///< Cifra scelta dalla ricerca tra i candidati della cella
+        NAKED_SINGLE, ///< Unico candidato rimasto nella cella
+        HIDDEN_SINGLE ///< Unica cella di una riga, colonna o casella per la
+                      ///< cifra
+    };
+
+    /**
+     * @brief Propagazione dei vincoli eseguita prima di ogni scelta.
+     */
+    enum Propagation {
+        NO_PROPAGATION, ///< Solo ricerca
+        SINGLES, ///< Singoli nudi e nascosti
+        LOCKED_CANDIDATES ///< Singoli e candidati bloccati
+    };
+
+    /**
+     * @brief Mossa del solver: valore inserito in una cella.
+     */
+    struct Move {
+        int row; ///< Riga della cella
+        int column; ///< Colonna della cella
+        short value; ///< Valore inserito
+        MoveKind kind; ///< Scelta della ricerca o deduzione
+
+        Move() : row(0), column(0), value(0), kind(GUESS) {}
+        Move(int r, int c, short v, MoveKind k = GUESS) : row(r), column(c),
+                value(v), kind(k) {}
+    };
+
+    /**
+     * @brief Insieme di cifre, il bit d - 1 è acceso se contiene la cifra d.
+     */
+    typedef typename std::conditional<SIZE <= 16, std::uint16_t,
+                                      std::uint32_t>::type digit_mask;
+
+    enum {
+        ALL_DIGITS = (1 << SIZE) - 1 ///< Maschera con tutte le cifre
+    };
+
+private:
+    /**
+     * @brief Indice di una cella in ordine di riga.
+     */
+    typedef typename std::conditional<CELLS <= 256, unsigned char,
+                                      unsigned short>::type cell_index;
+
+    /**
+     * @brief Candidati tolti a una cella, per ripristinarli.
+     */
+    struct Elimination {
+        cell_index cell; ///< Cella, in ordine di riga
+        digit_mask previous; ///< Candidati tolti prima della modifica
+    };
+
+    short _grid[SIZE][SIZE]; ///< Valori delle celle, 0 se vuote
+    std::vector<Move> _moves; ///< Mosse della soluzione
+    unsigned long long _nodes; ///< Nodi visitati dall'ultima ricerca
+    Propagation _propagation; ///< Deduzioni usate da solve e deduce
+    SudokuMonitor* _monitor; ///< Osservatore della ricerca in corso
+    unsigned long long _interval; ///< Nodi tra due chiamate a _monitor
+    unsigned long long _next_report; ///< Nodo della prossima chiamata
+    bool _interrupted; ///< Ricerca interrotta da _monitor
+    unsigned long long _limit; ///< Soluzioni cercate prima di fermarsi
+    unsigned long long _solutions; ///< Soluzioni trovate dall'ultima ricerca
+
+    digit_mask _rows[SIZE]; ///< Cifre usate in ogni riga durante solve
+    digit_mask _columns[SIZE]; ///< Cifre usate in ogni colonna durante solve
+    digit_mask _boxes[SIZE]; ///< Cifre usate in ogni casella durante solve
+
+    /**
+     * @brief Celle vuote all'inizio di solve, come indici in ordine di riga.
+     *
+     * Le prime _filled sono quelle riempite dal solver, nell'ordine in cui
+     * sono state riempite, le altre sono ancora vuote. Così annullare gli
+     * inserimenti fino a un punto della ricerca significa solo scorrere
+     * l'array all'indietro.
+     */
+    cell_index _empty[CELLS];
+    cell_index _position[CELLS]; ///< Posizione di ogni cella in _empty
+    unsigned char _kinds[CELLS]; ///< MoveKind delle celle riempite in _empty
+    int _empty_count; ///< Numero di celle vuote all'inizio di solve
+    int _filled; ///< Celle di _empty riempite dal solver
+
+    digit_mask _eliminated[CELLS]; ///< Candidati tolti a ogni cella
+    Elimination _trail[CELLS * SIZE]; ///< Modifiche a _eliminated
+    int _trail_size; ///< Elementi di _trail in uso
+
+    /**
+     * @brief Indice della casella che contiene la cella.
+     */
+    static constexpr int boxOf(int row, int column) {
+        return row / BOX * BOX + column / BOX;
+    }
+
+    /**
+     * @brief Cella k-esima della casella b, in ordine di riga.
+     */
+    static constexpr int boxCell(int b, int k) {
+        return (b / BOX * BOX + k / BOX) * SIZE + b % BOX * BOX + k % BOX;
+    }
+
+    /**
+     * @brief Cella k-esima dell'unità u, in ordine di riga.
+     *
+     * Le unità da 0 a SIZE - 1 sono le righe, poi vengono le colonne e le
+     * caselle. Usata solo per generare UNIT_CELLS.
+     */
+    static constexpr int unitCell(int u, int k) {
+        return u < SIZE ? u * SIZE + k
+             : u < 2 * SIZE ? k * SIZE + u - SIZE
+             : boxCell(u - 2 * SIZE, k);
+    }
+
+    /**
+     * @brief Unità t-esima della cella: riga, colonna o casella.
+     */
+    static constexpr int cellUnit(int cell, int t) {
+        return t == 0 ? cell / SIZE
+             : t == 1 ? SIZE + cell % SIZE
+             : 2 * SIZE + boxOf(cell / SIZE, cell % SIZE);
+    }
+
+public:
+    /**
+     * @brief Celle di ogni unità: cells[u][k] è la cella k-esima dell'unità
+     * u, in ordine di riga.
+     */
+    struct UnitCells {
+        cell_index cells[UNITS][SIZE];
+    };
+
+    /**
+     * @brief Unità di ogni cella: units[cell] contiene la riga, SIZE più la
+     * colonna e 2 · SIZE più la casella.
+     */
+    struct CellUnits {
+        unsigned char units[CELLS][3];
+    };
+
+    /**
+     * @brief Geometria delle unità, calcolata in compilazione.
+     *
+     * Usata dalla propagazione al posto delle divisioni di unitCell, e
+     * condivisa con SudokuLanes e DancingLinksSolver.
+     */
+    static const UnitCells UNIT_CELLS;
+    static const CellUnits CELL_UNITS; ///< Inversa di UNIT_CELLS
+
+private:
+    /**
+     * @brief Genera UNIT_CELLS, un elemento per ogni indice di I.
+     */
+    template <int... I>
+    static constexpr UnitCells unitCells(IndexList<I...>) {
+        return UnitCells{{
+            static_cast<cell_index>(unitCell(I / SIZE, I % SIZE))...
+        }};
+    }
+
+    /**
+     * @brief Genera CELL_UNITS, un elemento per ogni indice di I.
+     */
+    template <int... I>
+    static constexpr CellUnits cellUnits(IndexList<I...>) {
+        return CellUnits{{
+            static_cast<unsigned char>(cellUnit(I / 3, I % 3))...
+        }};
+    }
+
+    /**
+     * @brief Cifre già inserite nell'unità u.
+     */
+    digit_mask unitDigits(int u) const {
+        if (u < SIZE) {
+            return _rows[u];
+        }
+        if (u < 2 * SIZE) {
+            return _columns[u - SIZE];
+        }
+        return _boxes[u - 2 * SIZE];
+    }
+
+    /**
+     * @brief Calcola le maschere delle cifre usate dalle celle piene.
+     *
+     * @param rows Maschere delle righe, in output.
+     * @param columns Maschere delle colonne, in output.
+     * @param boxes Maschere delle caselle, in output.
+     * @return false se una riga, colonna o casella contiene due volte la
+     *  stessa cifra, true altrimenti.
+     */
+    bool computeMasks(digit_mask rows[SIZE], digit_mask columns[SIZE],
+            digit_mask boxes[SIZE]) const {
+        for (int i = 0; i < SIZE; ++i) {
+            rows[i] = columns[i] = boxes[i] = 0;
+        }
+
+        for (int i = 0; i < SIZE; ++i) {
+            for (int j = 0; j < SIZE; ++j) {
+                if (_grid[i][j] == 0) {
+                    continue;
+                }
+                const digit_mask bit = 1 << (_grid[i][j] - 1);
+                const int b = boxOf(i, j);
+                if ((rows[i] | columns[j] | boxes[b]) & bit) {
+                    return false;
+                }
+                rows[i] |= bit;
+                columns[j] |= bit;
+                boxes[b] |= bit;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Inserisce o toglie la cifra value nelle maschere della cella.
+     *
+     * Inserimento e annullamento sono la stessa operazione, uno XOR.
+     */
+    void flipDigit(int row, int column, short value) {
+        const digit_mask bit = 1 << (value - 1);
+        _rows[row] ^= bit;
+        _columns[column] ^= bit;
+        _boxes[boxOf(row, column)] ^= bit;
+    }
+
+    /**
+     * @brief Cifre che possono essere inserite nella cella durante la
+     * ricerca, quando le maschere sono aggiornate.
+     *
+     * @param cell Cella vuota, in ordine di riga.
+     */
+    digit_mask candidates(int cell) const {
+        const int row = cell / SIZE;
+        const int column = cell % SIZE;
+        return ALL_DIGITS & ~(_rows[row] | _columns[column] |
+                              _boxes[boxOf(row, column)] | _eliminated[cell]);
+    }
+
+    /**
+     * @brief Prepara lo stato della ricerca per la griglia corrente.
+     *
+     * @return false se la griglia non è valida.
+     */
+    bool start() {
+        _moves.clear();
+        _nodes = 0;
+        _interrupted = false;
+        _solutions = 0;
+        if (!computeMasks(_rows, _columns, _boxes)) {
+            return false;
+        }
+
+        _empty_count = 0;
+        _filled = 0;
+        _trail_size = 0;
+        for (int k = 0; k < CELLS; ++k) {
+            _eliminated[k] = 0;
+            if (_grid[k / SIZE][k % SIZE] == 0) {
+                _position[k] = static_cast<cell_index>(_empty_count);
+                _empty[_empty_count++] = static_cast<cell_index>(k);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Riempie una cella vuota e la sposta tra quelle riempite.
+     */
+    void place(int cell, short value, MoveKind kind) {
+        const int row = cell / SIZE;
+        const int column = cell % SIZE;
+        _grid[row][column] = value;
+        flipDigit(row, column, value);
+
+        const int from = _position[cell];
+        const int other = _empty[_filled];
+        _empty[from] = static_cast<cell_index>(other);
+        _position[other] = static_cast<cell_index>(from);
+        _empty[_filled] = static_cast<cell_index>(cell);
+        _position[cell] = static_cast<cell_index>(_filled);
+        _kinds[_filled] = static_cast<unsigned char>(kind);
+        ++_filled;
+    }
+
+    /**
+     * @brief Toglie a una cella vuota i candidati in digits.
+     *
+     * @return true se la cella ha perso almeno un candidato.
+     */
+    bool eliminate(int cell, digit_mask digits) {
+        if (_grid[cell / SIZE][cell % SIZE] != 0 ||
+                (candidates(cell) & digits) == 0) {
+            return false;
+        }
+        _trail[_trail_size].cell = static_cast<cell_index>(cell);
+        _trail[_trail_size].previous = _eliminated[cell];
+        ++_trail_size;
+        _eliminated[cell] |= digits;
+        return true;
+    }
+
+    /**
+     * @brief Annulla inserimenti ed eliminazioni successivi al punto
+     * indicato.
+     *
+     * @param filled Valore di _filled da ripristinare.
+     * @param trail_size Valore di _trail_size da ripristinare.
+     */
+    void undo(int filled, int trail_size) {
+        while (_filled > filled) {
+            --_filled;
+            const int cell = _empty[_filled];
+            const int row = cell / SIZE;
+            const int column = cell % SIZE;
+            flipDigit(row, column, _grid[row][column]);
+            _grid[row][column] = 0;
+        }
+        while (_trail_size > trail_size) {
+            --_trail_size;
+            _eliminated[_trail[_trail_size].cell] =
+                _trail[_trail_size].previous;
+        }
+    }
+
+    /**
+     * @brief Riempie le celle con un solo candidato.
+     *
+     * @param changed Messo a true se viene riempita almeno una cella.
+     * @return false se una cella vuota non ha candidati.
+     */
+    bool nakedSingles(bool& changed) {
+        for (int k = _filled; k < _empty_count; ++k) {
+            const int cell = _empty[k];
+            const digit_mask mask = candidates(cell);
+            if (mask == 0) {
+                return false;
+            }
+            if ((mask & (mask - 1)) == 0) {
+                place(cell, static_cast<short>(lowestBit(mask) + 1),
+                      NAKED_SINGLE);
+                changed = true;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Riempie le celle che sono le sole della loro unità ad ammettere
+     * una cifra.
+     *
+     * Per ogni unità le cifre candidate in almeno una e in almeno due celle
+     * si ottengono con due maschere; quelle che compaiono una volta sola
+     * sono singoli nascosti.
+     *
+     * @param changed Messo a true se viene riempita almeno una cella.
+     * @return false se una cifra non può più essere inserita in un'unità o
+     *  due cifre richiedono la stessa cella.
+     */
+    bool hiddenSingles(bool& changed) {
+        for (int u = 0; u < UNITS; ++u) {
+            const cell_index* cells = UNIT_CELLS.cells[u];
+            digit_mask once = 0, twice = 0;
+            for (int k = 0; k < SIZE; ++k) {
+                const int cell = cells[k];
+                if (_grid[cell / SIZE][cell % SIZE] == 0) {
+                    const digit_mask mask = candidates(cell);
+                    twice |= once & mask;
+                    once |= mask;
+                }
+            }
+
+            const digit_mask needed = ALL_DIGITS & ~unitDigits(u);
+            if ((once & needed) != needed) {
+                return false;
+            }
+
+            for (digit_mask singles = once & ~twice; singles != 0;
+                    singles &= singles - 1) {
+                const digit_mask bit = singles & -singles;
+                int k = 0;
+                int cell = cells[k];
+                while (_grid[cell / SIZE][cell % SIZE] != 0 ||
+                        (candidates(cell) & bit) == 0) {
+                    if (++k == SIZE) {
+                        return false;
+                    }
+                    cell = cells[k];
+                }
+                place(cell, static_cast<short>(lowestBit(bit) + 1),
+                      HIDDEN_SINGLE);
+                changed = true;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Toglie i candidati esclusi dai candidati bloccati.
+     *
+     * Ogni riga (e colonna) incrocia BOX caselle in BOX segmenti di BOX
+     * celle. Se in una casella una cifra è candidata solo nel segmento di
+     * una riga, non può comparire nel resto della riga (pointing); se in
+     * una riga è candidata solo nel segmento di una casella, non può
+     * comparire nel resto della casella (claiming).
+     *
+     * @param changed Messo a true se viene tolto almeno un candidato.
+     */
+    void lockedCandidates(bool& changed) {
+        // Prima le righe, poi le colonne con gli indici scambiati
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool rows = pass == 0;
+            digit_mask segment[SIZE][BOX];
+            for (int i = 0; i < SIZE; ++i) {
+                for (int t = 0; t < BOX; ++t) {
+                    digit_mask mask = 0;
+                    for (int k = t * BOX; k < t * BOX + BOX; ++k) {
+                        const int cell = rows ? i * SIZE + k : k * SIZE + i;
+                        if (_grid[cell / SIZE][cell % SIZE] == 0) {
+                            mask |= candidates(cell);
+                        }
+                    }
+                    segment[i][t] = mask;
+                }
+            }
+
+            for (int i = 0; i < SIZE; ++i) {
+                const int band = i - i % BOX;
+                for (int t = 0; t < BOX; ++t) {
+                    // Pointing: solo in questo segmento della casella
+                    digit_mask others = 0;
+                    for (int j = band; j < band + BOX; ++j) {
+                        if (j != i) {
+                            others |= segment[j][t];
+                        }
+                    }
+                    const digit_mask pointing = segment[i][t] & ~others;
+
+                    // Claiming: solo in questo segmento della riga
+                    others = 0;
+                    for (int v = 0; v < BOX; ++v) {
+                        if (v != t) {
+                            others |= segment[i][v];
+                        }
+                    }
+                    const digit_mask claiming = segment[i][t] & ~others;
+
+                    for (int k = 0; k < SIZE; ++k) {
+                        if (pointing != 0 && k / BOX != t) {
+                            const int cell = rows ? i * SIZE + k
+                                                  : k * SIZE + i;
+                            changed |= eliminate(cell, pointing);
+                        }
+                        const int j = band + k / BOX;
+                        const int c = t * BOX + k % BOX;
+                        if (claiming != 0 && j != i) {
+                            const int cell = rows ? j * SIZE + c
+                                                  : c * SIZE + j;
+                            changed |= eliminate(cell, claiming);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Applica le deduzioni attive finché la griglia non cambia più.
+     *
+     * @return false se la griglia parziale non ha soluzioni.
+     */
+    bool propagate() {
+        if (_propagation == NO_PROPAGATION) {
+            return true;
+        }
+
+        // Le deduzioni più costose solo quando le altre non bastano
+        bool changed = true;
+        while (changed && _filled < _empty_count) {
+            changed = false;
+            if (!nakedSingles(changed)) {
+                return false;
+            }
+            if (!changed && !hiddenSingles(changed)) {
+                return false;
+            }
+            if (!changed && _propagation == LOCKED_CANDIDATES) {
+                lockedCandidates(changed);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sceglie la cella vuota con meno candidati.
+     *
+     * Le celle vuote vengono scandite con un popcount delle maschere dei
+     * candidati; la scansione si ferma alla prima cella con un solo
+     * candidato, o con nessuno: in questo caso la griglia parziale non ha
+     * soluzioni. A parità di candidati vince la prima cella di _empty.
+     *
+     * @param best Cella scelta, in output.
+     * @param best_mask Candidati della cella scelta, in output.
+     * @return Il numero di candidati della cella scelta.
+     * @pre _filled < _empty_count
+     */
+    unsigned int chooseCell(int& best, digit_mask& best_mask) const {
+        best = _empty[_filled];
+        best_mask = 0;
+        unsigned int best_count = SIZE + 1;
+        for (int k = _filled; k < _empty_count; ++k) {
+            const int cell = _empty[k];
+            const digit_mask mask = candidates(cell);
+            const unsigned int count = bitCount(mask);
+            if (count < best_count) {
+                best = cell;
+                best_mask = mask;
+                best_count = count;
+                if (count <= 1) {
+                    break;
+                }
+            }
+        }
+        return best_count;
+    }
+
+    /**
+     * @brief Ricerca ricorsiva: propaga i vincoli, poi prova i candidati
+     * della cella vuota che ne ha meno.
+     *
+     * La cella viene scelta con chooseCell e se non ha candidati la ricerca
+     * torna subito indietro. Le cifre vengono provate in ordine crescente,
+     * enumerando i bit accesi dei candidati. Ogni griglia completata conta
+     * come una soluzione: la ricerca si ferma quando le soluzioni arrivano
+     * a _limit, altrimenti annulla la soluzione e continua con il candidato
+     * successivo. Se la ricerca fallisce, la griglia torna com'era alla
+     * chiamata. Con un SudokuMonitor che chiede di fermarsi la ricerca
+     * torna indietro senza provare altri candidati.
+     *
+     * @param depth Scelte nel ramo corrente.
+     * @return true se la ricerca si è fermata su una griglia completa dopo
+     *  _limit soluzioni, false altrimenti.
+     */
+    bool search(int depth) {
+        ++_nodes;
+        if (_monitor != nullptr && _nodes >= _next_report) {
+            _next_report = _nodes + _interval;
+            _interrupted = !_monitor->progress(_nodes, depth);
+        }
+        if (_interrupted) {
+            return false;
+        }
+
+        const int filled = _filled;
+        const int trail_size = _trail_size;
+        if (!propagate()) {
+            undo(filled, trail_size);
+            return false;
+        }
+        if (_filled == _empty_count) {
+            if (++_solutions >= _limit) {
+                return true;
+            }
+            undo(filled, trail_size);
+            return false;
+        }
+
+        int best;
+        digit_mask best_mask;
+        if (chooseCell(best, best_mask) != 0) {
+            const int propagated = _filled;
+            const int propagated_trail = _trail_size;
+            for (digit_mask left = best_mask; left != 0; left &= left - 1) {
+                place(best, static_cast<short>(lowestBit(left) + 1), GUESS);
+                if (search(depth + 1)) {
+                    return true;
+                }
+                undo(propagated, propagated_trail);
+                if (_interrupted) {
+                    break;
+                }
+            }
+        }
+
+        undo(filled, trail_size);
+        return false;
+    }
+
+    /**
+     * @brief Visita l'albero della ricerca fino a remaining scelte e
+     * aggiunge a tasks le griglie parziali raggiunte.
+     *
+     * Le griglie completate prima di remaining scelte vengono contate in
+     * _solutions. La griglia torna com'era alla chiamata.
+     */
+    void splitSearch(int remaining, std::vector<std::string>& tasks) {
+        ++_nodes;
+        const int filled = _filled;
+        const int trail_size = _trail_size;
+        if (!propagate()) {
+            undo(filled, trail_size);
+            return;
+        }
+        if (_filled == _empty_count) {
+            ++_solutions;
+        }
+        else if (remaining == 0) {
+            tasks.push_back(str());
+        }
+        else {
+            int best;
+            digit_mask best_mask;
+            if (chooseCell(best, best_mask) != 0) {
+                const int propagated = _filled;
+                const int propagated_trail = _trail_size;
+                for (digit_mask left = best_mask; left != 0;
+                        left &= left - 1) {
+                    place(best, static_cast<short>(lowestBit(left) + 1),
+                          GUESS);
+                    splitSearch(remaining - 1, tasks);
+                    undo(propagated, propagated_trail);
+                }
+            }
+        }
+        undo(filled, trail_size);
+    }
+
+    /**
+     * @brief Copia in _moves le celle riempite, dalla più recente alla
+     * prima.
+     */
+    void recordMoves() {
+        _moves.clear();
+        _moves.reserve(_filled);
+        for (int k = _filled; k-- > 0;) {
+            const int cell = _empty[k];
+            _moves.push_back(Move(cell / SIZE, cell % SIZE,
+                                  _grid[cell / SIZE][cell % SIZE],
+                                  static_cast<MoveKind>(_kinds[k])));
+        }
+    }
+
+public:
+
+    /**
+     * @brief Costruttore di default, crea una griglia vuota.
+     */
+    BasicSudoku() : _nodes(0), _propagation(SINGLES), _monitor(nullptr),
+            _interval(0), _next_report(0), _interrupted(false), _limit(1),
+            _solutions(0), _empty(), _position(), _kinds(), _empty_count(0),
+            _filled(0), _eliminated(), _trail(), _trail_size(0) {
+        clear();
+    }
+
+    /**
+     * @brief Costruttore, copia la griglia indicata.
+     *
+     * @param grid Valori delle celle, 0 per le celle vuote.
+     * @pre ogni valore è compreso tra 0 e SIZE
+     */
+    explicit BasicSudoku(const short grid[SIZE][SIZE]) : _nodes(0),
+            _propagation(SINGLES), _monitor(nullptr), _interval(0),
+            _next_report(0), _interrupted(false), _limit(1), _solutions(0),
+            _empty(), _position(), _kinds(), _empty_count(0), _filled(0),
+            _eliminated(), _trail(), _trail_size(0) {
+        clear();
+        for (int i = 0; i < SIZE; ++i) {
+            for (int j = 0; j < SIZE; ++j) {
+                set(i, j, grid[i][j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Svuota la griglia e dimentica l'ultima soluzione.
+     *
+     * La propagazione scelta non cambia.
+     */
+    void clear() {
+        for (int i = 0; i < SIZE; ++i) {
+            for (int j = 0; j < SIZE; ++j) {
+                _grid[i][j] = 0;
+            }
+            _rows[i] = _columns[i] = _boxes[i] = 0;
+        }
+        _moves.clear();
+        _nodes = 0;
+        _interrupted = false;
+        _solutions = 0;
+    }
+
+    /**
+     * @brief Sceglie le deduzioni usate da solve e deduce.
+     *
+     * Il default è SINGLES. NO_PROPAGATION lascia tutto alla ricerca.
+     */
+    void setPropagation(Propagation propagation) {
+        _propagation = propagation;
+    }
+
+    /**
+     * @brief Ritorna le deduzioni usate da solve e deduce.
+     */
+    Propagation propagation() const {
+        return _propagation;
+    }
+
+    /**
+     * @brief Ritorna il valore di una cella, 0 se vuota.
+     *
+     * @pre 0 <= row < SIZE e 0 <= column < SIZE
+     */
+    short get(int row, int column) const {
+        assert(row >= 0 && row < SIZE && column >= 0 && column < SIZE);
+        return _grid[row][column];
+    }
+
+    /**
+     * @brief Assegna il valore di una cella, 0 per svuotarla.
+     *
+     * @pre 0 <= row < SIZE, 0 <= column < SIZE e 0 <= value <= SIZE
+     */
+    void set(int row, int column, short value) {
+        assert(row >= 0 && row < SIZE && column >= 0 && column < SIZE);
+        assert(value >= 0 && value <= SIZE);
+        _grid[row][column] = value;
+    }
+
+    /**
+     * @brief Controlla che le celle piene rispettino le regole del Sudoku.
+     *
+     * @return true se nessuna riga, colonna o casella contiene due volte lo
+     *  stesso valore, false altrimenti.
+     */
+    bool valid() const {
+        digit_mask rows[SIZE], columns[SIZE], boxes[SIZE];
+        return computeMasks(rows, columns, boxes);
+    }
+
+    /**
+     * @brief Controlla se tutte le celle sono piene.
+     */
+    bool complete() const {
+        for (int i = 0; i < SIZE; ++i) {
+            for (int j = 0; j < SIZE; ++j) {
+                if (_grid[i][j] == 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Risolve il Sudoku.
+     *
+     * Se esiste una soluzione le celle vuote vengono riempite, altrimenti la
+     * griglia resta invariata. In entrambi i casi moves() e nodes()
+     * descrivono la ricerca appena eseguita.
+     *
+     * @return true se il Sudoku è stato risolto, false se la griglia non è
+     *  valida o non ha soluzioni.
+     */
+    bool solve() {
+        if (!start()) {
+            return false;
+        }
+        _limit = 1;
+        if (!search(0)) {
+            return false;
+        }
+        recordMoves();
+        return true;
+    }
+
+    /**
+     * @brief Risolve il Sudoku come solve(), chiamando monitor.progress
+     * ogni interval nodi.
+     *
+     * Se progress ritorna false la ricerca si ferma, la griglia resta
+     * invariata e interrupted() ritorna true.
+     *
+     * @pre interval > 0
+     */
+    bool solve(SudokuMonitor& monitor, unsigned long long interval = 1024) {
+        assert(interval > 0);
+        _monitor = &monitor;
+        _interval = interval;
+        _next_report = interval;
+        const bool solved = solve();
+        _monitor = nullptr;
+        return solved;
+    }
+
+    /**
+     * @brief Controlla se l'ultima ricerca è stata interrotta da un
+     * SudokuMonitor prima di trovare una soluzione o di escluderla.
+     */
+    bool interrupted() const {
+        return _interrupted;
+    }
+
+    /**
+     * @brief Conta le soluzioni del Sudoku, fermandosi a limit.
+     *
+     * La ricerca è quella di solve, che invece di fermarsi alla prima
+     * soluzione continua fino a trovarne limit o a esaurire i candidati:
+     * countSolutions(2) == 1 controlla che la soluzione sia unica, e una
+     * seconda soluzione ferma subito la ricerca. La griglia resta
+     * invariata, moves() è vuoto e nodes() descrive la ricerca.
+     *
+     * @return Il numero di soluzioni se è minore di limit, altrimenti
+     *  limit; 0 se la griglia non è valida.
+     * @pre limit > 0
+     */
+    unsigned long long countSolutions(unsigned long long limit) {
+        assert(limit > 0);
+        if (!start()) {
+            return 0;
+        }
+        _limit = limit;
+        search(0);
+        undo(0, 0);
+        return _solutions;
+    }
+
+    /**
+     * @brief Conta le soluzioni come countSolutions(limit), chiamando
+     * monitor.progress ogni interval nodi.
+     *
+     * Se progress ritorna false la ricerca si ferma, interrupted() ritorna
+     * true e il risultato conta solo le soluzioni trovate fino a quel
+     * momento. Durante la ricerca progress può leggerle con solutions().
+     *
+     * @pre limit > 0 e interval > 0
+     */
+    unsigned long long countSolutions(unsigned long long limit,
+            SudokuMonitor& monitor, unsigned long long interval = 1024) {
+        assert(interval > 0);
+        _monitor = &monitor;
+        _interval = interval;
+        _next_report = interval;
+        const unsigned long long solutions = countSolutions(limit);
+        _monitor = nullptr;
+        return solutions;
+    }
+
+    /**
+     * @brief Ritorna le soluzioni trovate dall'ultima ricerca, anche mentre
+     * è in corso.
+     */
+    unsigned long long solutions() const {
+        return _solutions;
+    }
+
+    /**
+     * @brief Divide la ricerca in sottoproblemi indipendenti.
+     *
+     * Visita l'albero della ricerca di countSolutions fino a depth scelte e
+     * aggiunge a tasks, nel formato di str(), le griglie parziali raggiunte
+     * a quella profondità. I rami sono disgiunti: le soluzioni del Sudoku
+     * sono quelle dei sottoproblemi più quelle completate dalla
+     * propagazione prima di depth scelte, che split ritorna. La griglia
+     * resta invariata, nodes() conta i nodi visitati.
+     *
+     * @param depth Scelte che separano un sottoproblema dalla griglia.
+     * @param tasks Sottoproblemi, a cui vengono aggiunte le griglie.
+     * @return Le soluzioni trovate prima di depth scelte; 0 se la griglia
+     *  non è valida.
+     * @pre depth >= 0
+     */
+    unsigned long long split(int depth, std::vector<std::string>& tasks) {
+        assert(depth >= 0);
+        if (!start()) {
+            return 0;
+        }
+        splitSearch(depth, tasks);
+        return _solutions;
+    }
+
+    /**
+     * @brief Applica solo la propagazione dei vincoli, senza ricerca.
+     *
+     * Riempie le celle che le deduzioni scelte con setPropagation
+     * determinano (nessuna con NO_PROPAGATION); la griglia può restare
+     * incompleta. moves() elenca le celle riempite, nodes() vale 0.
+     *
+     * @return false se la griglia non è valida o le deduzioni mostrano che
+     *  non ha soluzioni; in questo caso la griglia resta invariata.
+     */
+    bool deduce() {
+        if (!start()) {
+            return false;
+        }
+        if (!propagate()) {
+            undo(0, 0);
+            return false;
+        }
+        recordMoves();
+        return true;
+    }
+
+    /**
+     * @brief Ritorna le mosse dell'ultima soluzione, dalla più recente alla
+     * prima.
+     *
+     * Le mosse dedotte dalla propagazione sono distinte da quelle scelte
+     * dalla ricerca tramite Move::kind.
+     */
+    const std::vector<Move>& moves() const {
+        return _moves;
+    }
+
+    /**
+     * @brief Ritorna i nodi visitati dall'ultima ricerca.
+     *
+     * Ogni nodo è un passo della ricerca ricorsiva, cioè una griglia
+     * parziale da cui si propagano i vincoli e si sceglie una cella vuota.
+     */
+    unsigned long long nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Carattere che rappresenta value in read e str: le cifre da 1 a
+     * 9, poi le lettere maiuscole da 'A' (10) in avanti, '.' per 0.
+     */
+    static char digitChar(short value) {
+        return value == 0 ? '.'
+             : static_cast<char>(value <= 9 ? '0' + value : 'A' + value - 10);
+    }
+
+    /**
+     * @brief Valore rappresentato da c, l'inverso di digitChar; '0' vale 0
+     * solo se SIZE <= 9.
+     *
+     * @return Il valore, o -1 se c non rappresenta un valore da 0 a SIZE.
+     */
+    static short charDigit(char c) {
+        int value = -1;
+        if (c == '.' || (c == '0' && SIZE <= 9)) {
+            value = 0;
+        }
+        else if (c >= '1' && c <= '9') {
+            value = c - '0';
+        }
+        else if (c >= 'A' && c <= 'Z') {
+            value = c - 'A' + 10;
+        }
+        return static_cast<short>(value <= SIZE ? value : -1);
+    }
+
+    /**
+     * @brief Legge la griglia da una riga di CELLS caratteri, 81 per il
+     * Sudoku 9x9.
+     *
+     * Le celle sono elencate per righe; le cifre da 1 a 9 e le lettere da
+     * 'A' (10) in avanti sono celle piene, '.' celle vuote, come '0' se
+     * SIZE <= 9. Gli spazi finali, compreso '\\r', vengono ignorati.
+     *
+     * @param line Riga da leggere.
+     * @return true se la riga è nel formato corretto, false altrimenti; in
+     *  questo caso la griglia resta invariata.
+     */
+    bool read(const std::string& line) {
+        std::string::size_type length = line.size();
+        while (length > 0 && (line[length - 1] == ' ' ||
+                line[length - 1] == '\t' || line[length - 1] == '\r')) {
+            --length;
+        }
+        if (length != CELLS) {
+            return false;
+        }
+        for (int k = 0; k < CELLS; ++k) {
+            if (charDigit(line[k]) < 0) {
+                return false;
+            }
+        }
+
+        for (int k = 0; k < CELLS; ++k) {
+            _grid[k / SIZE][k % SIZE] = charDigit(line[k]);
+        }
+        _moves.clear();
+        _nodes = 0;
+        return true;
+    }
+
+    /**
+     * @brief Ritorna la griglia come riga di CELLS caratteri nel formato di
+     * read, '.' per le celle vuote.
+     */
+    std::string str() const {
+        std::string line(CELLS, '.');
+        for (int k = 0; k < CELLS; ++k) {
+            line[k] = digitChar(_grid[k / SIZE][k % SIZE]);
+        }
+        return line;
+    }
+};
+
+template <int B>
+constexpr typename BasicSudoku<B>::UnitCells BasicSudoku<B>::UNIT_CELLS =
+    BasicSudoku<B>::unitCells(typename IndexRange<UNITS * SIZE>::type());
+
+template <int B>
+constexpr typename BasicSudoku<B>::CellUnits BasicSudoku<B>::CELL_UNITS =
+    BasicSudoku<B>::cellUnits(typename IndexRange<CELLS * 3>::type());
+
+/**
+ * @brief Il Sudoku classico 9x9, usato dall'applicazione Qt, dai solver e
+ * dalla riga di comando.
+ */
+typedef BasicSudoku<3> Sudoku;
+
+/**
+ * @brief Interfaccia comune dei solver di Sudoku.
+ *
+ * Ogni solver risolve la griglia di un Sudoku, registra le mosse nello
+ * stesso formato di Sudoku::moves() e conta i nodi visitati; solve misura
+ * anche il tempo impiegato. Un solver può essere riusato per più Sudoku:
+ * lo stato della ricerca viene preparato alla costruzione.
+ */
+class SudokuSolver {
+    double _seconds; ///< Durata dell'ultima risoluzione
+
+    SudokuSolver(const SudokuSolver&); // Non copiabile
+    SudokuSolver& operator=(const SudokuSolver&); // Non assegnabile
+
+protected:
+    std::vector<Sudoku::Move> _moves; ///< Mosse dell'ultima soluzione
+    unsigned long long _nodes; ///< Nodi visitati dall'ultima ricerca
+
+    SudokuSolver() : _seconds(0), _nodes(0) {
+        _moves.reserve(Sudoku::CELLS);
+    }
+
+    /**
+     * @brief Risolve sudoku, aggiornando _moves e _nodes.
+     */
+    virtual bool run(Sudoku& sudoku) = 0;
+
+public:
+    virtual ~SudokuSolver() {}
+
+    /**
+     * @brief Risolve il Sudoku.
+     *
+     * Se esiste una soluzione le celle vuote di sudoku vengono riempite,
+     * altrimenti la griglia resta invariata.
+     *
+     * @return true se il Sudoku è stato risolto, false se la griglia non è
+     *  valida o non ha soluzioni.
+     */
+    bool solve(Sudoku& sudoku) {
+        typedef std::chrono::steady_clock clock;
+
+        const clock::time_point start = clock::now();
+        _moves.clear();
+        _nodes = 0;
+        const bool solved = run(sudoku);
+        _seconds = std::chrono::duration<double>(clock::now() - start)
+            .count();
+        return solved;
+    }
+
+    /**
+     * @brief Ritorna le mosse dell'ultima soluzione, dalla più recente alla
+     * prima, come Sudoku::moves().
+     */
+    const std::vector<Sudoku::Move>& moves() const {
+        return _moves;
+    }
+
+    /**
+     * @brief Ritorna i nodi visitati dall'ultima ricerca.
+     */
+    unsigned long long nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Ritorna la durata in secondi dell'ultima chiamata a solve.
+     */
+    double seconds() const {
+        return _seconds;
+    }
+};
+
+/**
+ * @brief Solver con la ricerca di Sudoku::solve e la propagazione scelta.
+ */
+class BacktrackingSolver : public SudokuSolver {
+    Sudoku::Propagation _propagation; ///< Deduzioni usate
+
+protected:
+    bool run(Sudoku& sudoku) {
+        const Sudoku::Propagation previous = sudoku.propagation();
+        sudoku.setPropagation(_propagation);
+        const bool solved = sudoku.solve();
+        sudoku.setPropagation(previous);
+
+        _moves = sudoku.moves();
+        _nodes = sudoku.nodes();
+        return solved;
+    }
+
+public:
+    explicit BacktrackingSolver(
+            Sudoku::Propagation propagation = Sudoku::SINGLES) :
+            _propagation(propagation) {}
+};
+
+#endif //sudoku_h